@@ -269,6 +269,15 @@ bool AbstractCommand::execute()
           }
           segments_.push_back(segment);
         }
+        if (segments_.empty() && req_) {
+          // All segments are in use.  Take over the one held by much
+          // slower connection, so that the download is not bounded
+          // by the slowest server.
+          auto segment = sm->stealSegment(getCuid());
+          if (segment) {
+            segments_.push_back(segment);
+          }
+        }
         if (segments_.empty()) {
           // TODO socket could be pooled here if pipelining is
           // enabled...  Hmm, I don't think if pipelining is enabled
@@ -839,6 +848,13 @@ bool AbstractCommand::checkIfConnectionEstablished(
 {
   std::string error = socket->getSocketError();
   if (error.empty()) {
+    // Failed connections are recorded below, so record this one too.
+    if (resolveProxyMethod(req_->getProtocol()) != V_GET ||
+        !isProxyRequest(req_->getProtocol(), getOption())) {
+      e_->getRequestGroupMan()
+          ->getOrCreateServerStat(req_->getHost(), req_->getProtocol())
+          ->updateFailureRate(false);
+    }
     return true;
   }
 
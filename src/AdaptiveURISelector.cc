@@ -38,6 +38,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 #include "DownloadCommand.h"
 #include "DownloadContext.h"
@@ -185,20 +186,56 @@ std::string AdaptiveURISelector::selectOne(const std::deque<std::string>& uris)
   }
 }
 
+namespace {
+int getUriMaxSpeed(const std::shared_ptr<ServerStat>& ss)
+{
+  return std::max(ss->getSingleConnectionAvgSpeed(),
+                  ss->getMultiConnectionAvgSpeed());
+}
+} // namespace
+
+namespace {
+// Returns the speed we can expect from the server, taking into
+// account how often the attempts to the server fail.
+int getUriScore(const std::shared_ptr<ServerStat>& ss)
+{
+  return static_cast<int64_t>(getUriMaxSpeed(ss)) *
+         (1000 - ss->getFailureRate()) / 1000;
+}
+} // namespace
+
 std::string
 AdaptiveURISelector::getBestMirror(const std::deque<std::string>& uris) const
 {
+  std::vector<std::pair<int, const std::string*>> scores;
+  int max = -1;
+  std::string best = A2STR::NIL;
+  for (auto& u : uris) {
+    auto ss = getServerStats(u);
+    if (!ss) {
+      continue;
+    }
+    int score = getUriScore(ss);
+    scores.push_back(std::make_pair(score, &u));
+    if (score > max) {
+      max = score;
+      best = u;
+    }
+  }
   /* Here we return one of the bests mirrors */
-  int max = getMaxDownloadSpeed(uris);
   int min = max - (int)(max * 0.25);
-  std::deque<std::string> bests = getUrisBySpeed(uris, min);
+  std::deque<std::string> bests;
+  for (auto& p : scores) {
+    if (p.first > min) {
+      bests.push_back(*p.second);
+    }
+  }
 
   if (bests.size() < 2) {
-    std::string uri = getMaxDownloadSpeedUri(uris);
     A2_LOG_DEBUG(fmt("AdaptiveURISelector: choosing the best mirror :"
                      " %.2fKB/s %s (other mirrors are at least 25%% slower)",
-                     (float)max / 1024, uri.c_str()));
-    return uri;
+                     (float)max / 1024, best.c_str()));
+    return best;
   }
   else {
     std::string uri = selectRandomUri(bests);
@@ -243,14 +280,6 @@ void AdaptiveURISelector::adjustLowestSpeedLimit(
   }
 }
 
-namespace {
-int getUriMaxSpeed(std::shared_ptr<ServerStat> ss)
-{
-  return std::max(ss->getSingleConnectionAvgSpeed(),
-                  ss->getMultiConnectionAvgSpeed());
-}
-} // namespace
-
 int AdaptiveURISelector::getMaxDownloadSpeed(
     const std::deque<std::string>& uris) const
 {
@@ -282,23 +311,6 @@ std::string AdaptiveURISelector::getMaxDownloadSpeedUri(
   return uri;
 }
 
-std::deque<std::string>
-AdaptiveURISelector::getUrisBySpeed(const std::deque<std::string>& uris,
-                                    int min) const
-{
-  std::deque<std::string> bests;
-  for (auto& uri : uris) {
-    std::shared_ptr<ServerStat> ss = getServerStats(uri);
-    if (!ss)
-      continue;
-    if (ss->getSingleConnectionAvgSpeed() > min ||
-        ss->getMultiConnectionAvgSpeed() > min) {
-      bests.push_back(uri);
-    }
-  }
-  return bests;
-}
-
 std::string
 AdaptiveURISelector::selectRandomUri(const std::deque<std::string>& uris) const
 {
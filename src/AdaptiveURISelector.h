@@ -61,13 +61,13 @@ private:
                               DownloadCommand* command) const;
   int getMaxDownloadSpeed(const std::deque<std::string>& uris) const;
   std::string getMaxDownloadSpeedUri(const std::deque<std::string>& uris) const;
-  std::deque<std::string> getUrisBySpeed(const std::deque<std::string>& uris,
-                                         int min) const;
   std::string selectRandomUri(const std::deque<std::string>& uris) const;
   std::string getFirstNotTestedUri(const std::deque<std::string>& uris) const;
   std::string getFirstToTestUri(const std::deque<std::string>& uris) const;
   std::shared_ptr<ServerStat> getServerStats(const std::string& uri) const;
   int getNbTestedServers(const std::deque<std::string>& uris) const;
+  // Returns one of the mirrors whose expected speed, discounted by
+  // its failure rate, is within 25% of the best one.
   std::string getBestMirror(const std::deque<std::string>& uris) const;
 
 public:
@@ -0,0 +1,140 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2009 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "CallbackDiskWriter.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "DlAbortEx.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+CallbackDiskWriter::CallbackDiskWriter(Callback callback,
+                                       size_t maxPendingLength)
+    : callback_(std::move(callback)),
+      deliveredLength_(0),
+      pendingLength_(0),
+      maxPendingLength_(maxPendingLength)
+{
+}
+
+CallbackDiskWriter::~CallbackDiskWriter() = default;
+
+void CallbackDiskWriter::initAndOpenFile(int64_t totalLength)
+{
+  pending_.clear();
+  deliveredLength_ = 0;
+  pendingLength_ = 0;
+}
+
+void CallbackDiskWriter::openFile(int64_t totalLength) {}
+
+void CallbackDiskWriter::closeFile() {}
+
+void CallbackDiskWriter::openExistingFile(int64_t totalLength) { openFile(); }
+
+void CallbackDiskWriter::deliver(const unsigned char* data, size_t len,
+                                 int64_t offset)
+{
+  // Skip the part which has already been delivered.
+  if (offset + static_cast<int64_t>(len) <= deliveredLength_) {
+    return;
+  }
+  size_t skip = deliveredLength_ - offset;
+  if (callback_(data + skip, len - skip, deliveredLength_) != 0) {
+    throw DL_ABORT_EX(fmt("Download data callback failed at offset %" PRId64,
+                          deliveredLength_));
+  }
+  deliveredLength_ = offset + len;
+}
+
+void CallbackDiskWriter::writeData(const unsigned char* data, size_t len,
+                                   int64_t offset)
+{
+  if (offset > deliveredLength_) {
+    if (pendingLength_ + len > maxPendingLength_) {
+      throw DL_ABORT_EX(fmt("Maximum pending length(%lu) exceeded.",
+                            static_cast<unsigned long>(maxPendingLength_)));
+    }
+    auto& buf = pending_[offset];
+    if (buf.size() < len) {
+      pendingLength_ += len - buf.size();
+      buf.assign(data, data + len);
+    }
+    return;
+  }
+  deliver(data, len, offset);
+  while (!pending_.empty() && pending_.begin()->first <= deliveredLength_) {
+    auto i = pending_.begin();
+    deliver(reinterpret_cast<const unsigned char*>(i->second.data()),
+            i->second.size(), i->first);
+    pendingLength_ -= i->second.size();
+    pending_.erase(i);
+  }
+}
+
+ssize_t CallbackDiskWriter::readData(unsigned char* data, size_t len,
+                                     int64_t offset)
+{
+  if (offset < deliveredLength_) {
+    throw DL_ABORT_EX(fmt("Data at offset %" PRId64
+                          " has already been passed to callback.",
+                          offset));
+  }
+  auto i = pending_.upper_bound(offset);
+  if (i == pending_.begin()) {
+    return 0;
+  }
+  --i;
+  int64_t last = i->first + static_cast<int64_t>(i->second.size());
+  if (last <= offset) {
+    return 0;
+  }
+  size_t n = std::min(len, static_cast<size_t>(last - offset));
+  memcpy(data, i->second.data() + (offset - i->first), n);
+  return n;
+}
+
+int64_t CallbackDiskWriter::size()
+{
+  int64_t res = deliveredLength_;
+  for (auto& e : pending_) {
+    res = std::max(res, e.first + static_cast<int64_t>(e.second.size()));
+  }
+  return res;
+}
+
+} // namespace aria2
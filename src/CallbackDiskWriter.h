@@ -0,0 +1,100 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2009 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_CALLBACK_DISK_WRITER_H
+#define D_CALLBACK_DISK_WRITER_H
+
+#include "DiskWriter.h"
+
+#include <map>
+#include <string>
+#include <functional>
+
+#include "a2functional.h"
+
+namespace aria2 {
+
+// DiskWriter which hands downloaded data to a callback function
+// instead of storing it.  The data is delivered in order: data
+// written ahead of the delivered range is kept in memory until the
+// gap is filled, up to maxPendingLength bytes.  Data already
+// delivered cannot be read back.
+class CallbackDiskWriter : public DiskWriter {
+public:
+  // Called with the data whose length is len, which starts at offset.
+  // Returns 0 if it succeeds, or nonzero to abort the download.
+  typedef std::function<int(const unsigned char* data, size_t len,
+                            int64_t offset)>
+      Callback;
+
+  CallbackDiskWriter(Callback callback, size_t maxPendingLength = 15_m);
+  virtual ~CallbackDiskWriter();
+
+  virtual void initAndOpenFile(int64_t totalLength = 0) CXX11_OVERRIDE;
+
+  virtual void openFile(int64_t totalLength = 0) CXX11_OVERRIDE;
+
+  virtual void closeFile() CXX11_OVERRIDE;
+
+  virtual void openExistingFile(int64_t totalLength = 0) CXX11_OVERRIDE;
+
+  virtual void writeData(const unsigned char* data, size_t len,
+                         int64_t offset) CXX11_OVERRIDE;
+
+  // Only the data not delivered yet can be read.
+  virtual ssize_t readData(unsigned char* data, size_t len,
+                           int64_t offset) CXX11_OVERRIDE;
+
+  virtual int64_t size() CXX11_OVERRIDE;
+
+  // Returns the number of bytes delivered to the callback so far.
+  int64_t getDeliveredLength() const { return deliveredLength_; }
+
+  // Returns the number of bytes waiting for the preceding data.
+  size_t getPendingLength() const { return pendingLength_; }
+
+private:
+  void deliver(const unsigned char* data, size_t len, int64_t offset);
+
+  Callback callback_;
+  // Data written ahead of deliveredLength_, keyed by offset.
+  std::map<int64_t, std::string> pending_;
+  int64_t deliveredLength_;
+  size_t pendingLength_;
+  size_t maxPendingLength_;
+};
+
+} // namespace aria2
+
+#endif // D_CALLBACK_DISK_WRITER_H
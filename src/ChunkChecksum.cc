@@ -37,35 +37,39 @@
 
 namespace aria2 {
 
-ChunkChecksum::ChunkChecksum() : pieceLength_(0) {}
+ChunkChecksum::ChunkChecksum() : pieceHashLength_(0), pieceLength_(0) {}
 
 ChunkChecksum::ChunkChecksum(std::string hashType,
-                             std::vector<std::string> pieceHashes,
+                             const std::vector<std::string>& pieceHashes,
                              int32_t pieceLength)
     : hashType_(std::move(hashType)),
-      pieceHashes_(std::move(pieceHashes)),
+      pieceHashLength_(0),
       pieceLength_(pieceLength)
 {
+  setPieceHashes(pieceHashes);
 }
 
 bool ChunkChecksum::validateChunk(const std::string& actualDigest,
                                   size_t index) const
 {
-  const std::string& digest = getPieceHash(index);
+  auto digest = getPieceHash(index);
   return !digest.empty() && actualDigest == digest;
 }
 
 int64_t ChunkChecksum::getEstimatedDataLength() const
 {
-  return static_cast<int64_t>(pieceLength_) * pieceHashes_.size();
+  return static_cast<int64_t>(pieceLength_) * countPieceHash();
 }
 
-size_t ChunkChecksum::countPieceHash() const { return pieceHashes_.size(); }
+size_t ChunkChecksum::countPieceHash() const
+{
+  return pieceHashLength_ == 0 ? 0 : pieceHashData_.size() / pieceHashLength_;
+}
 
-const std::string& ChunkChecksum::getPieceHash(size_t index) const
+std::string ChunkChecksum::getPieceHash(size_t index) const
 {
-  if (index < pieceHashes_.size()) {
-    return pieceHashes_[index];
+  if (index < countPieceHash()) {
+    return pieceHashData_.substr(index * pieceHashLength_, pieceHashLength_);
   }
   else {
     return A2STR::NIL;
@@ -77,9 +81,14 @@ void ChunkChecksum::setHashType(std::string hashType)
   hashType_ = std::move(hashType);
 }
 
-void ChunkChecksum::setPieceHashes(std::vector<std::string> pieceHashes)
+void ChunkChecksum::setPieceHashes(const std::vector<std::string>& pieceHashes)
 {
-  pieceHashes_ = std::move(pieceHashes);
+  pieceHashData_.clear();
+  pieceHashLength_ = pieceHashes.empty() ? 0 : pieceHashes[0].size();
+  pieceHashData_.reserve(pieceHashLength_ * pieceHashes.size());
+  for (auto& h : pieceHashes) {
+    pieceHashData_ += h;
+  }
 }
 
 } // namespace aria2
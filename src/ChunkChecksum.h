@@ -45,13 +45,16 @@ namespace aria2 {
 class ChunkChecksum {
 private:
   std::string hashType_;
-  std::vector<std::string> pieceHashes_;
+  // Piece hashes concatenated, each pieceHashLength_ bytes long
+  std::string pieceHashData_;
+  size_t pieceHashLength_;
   int32_t pieceLength_;
 
 public:
   ChunkChecksum();
 
-  ChunkChecksum(std::string hashType, std::vector<std::string> pieceHashes,
+  ChunkChecksum(std::string hashType,
+                const std::vector<std::string>& pieceHashes,
                 int32_t pieceLength);
 
   bool validateChunk(const std::string& actualDigest, size_t index) const;
@@ -60,13 +63,15 @@ public:
 
   size_t countPieceHash() const;
 
-  const std::string& getPieceHash(size_t index) const;
+  std::string getPieceHash(size_t index) const;
 
-  void setPieceHashes(std::vector<std::string> pieceHashes);
-  const std::vector<std::string>& getPieceHashes() const
-  {
-    return pieceHashes_;
-  }
+  // All pieceHashes must have the same length.
+  void setPieceHashes(const std::vector<std::string>& pieceHashes);
+
+  // Returns all piece hashes concatenated.
+  const std::string& getPieceHashData() const { return pieceHashData_; }
+
+  size_t getPieceHashLength() const { return pieceHashLength_; }
 
   void setHashType(std::string hashType);
   const std::string& getHashType() const { return hashType_; }
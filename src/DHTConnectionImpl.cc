@@ -36,6 +36,7 @@
 
 #include <utility>
 #include <algorithm>
+#include <cstring>
 
 #include "LogFactory.h"
 #include "Logger.h"
@@ -44,11 +45,15 @@
 #include "SocketCore.h"
 #include "SimpleRandomizer.h"
 #include "fmt.h"
+#include "a2functional.h"
 
 namespace aria2 {
 
 DHTConnectionImpl::DHTConnectionImpl(int family)
-    : socket_(std::make_shared<SocketCore>(SOCK_DGRAM)), family_(family)
+    : socket_(std::make_shared<SocketCore>(SOCK_DGRAM)),
+      family_(family),
+      numRecv_(0),
+      nextRecv_(0)
 {
 }
 
@@ -91,15 +96,34 @@ bool DHTConnectionImpl::bind(uint16_t& port, const std::string& addr)
 ssize_t DHTConnectionImpl::receiveMessage(unsigned char* data, size_t len,
                                           std::string& host, uint16_t& port)
 {
-  Endpoint remoteEndpoint;
-  ssize_t length = socket_->readDataFrom(data, len, remoteEndpoint);
-  if (length == 0) {
+  for (;;) {
+    if (nextRecv_ == numRecv_) {
+      if (!recvbuf_) {
+        recvbuf_ = make_unique<unsigned char[]>(RECV_BATCH_SIZE *
+                                                RECV_BUFFER_SIZE);
+      }
+      nextRecv_ = 0;
+      numRecv_ = 0;
+      numRecv_ =
+          socket_->readDataFromBatch(recvbuf_.get(), RECV_BUFFER_SIZE,
+                                     RECV_BATCH_SIZE, recvlens_.data(),
+                                     senders_.data());
+      if (numRecv_ == 0) {
+        return 0;
+      }
+    }
+    auto i = nextRecv_++;
+    if (recvlens_[i] == 0) {
+      A2_LOG_DEBUG(fmt("Discarded empty or too large datagram from %s:%u",
+                       senders_[i].addr.c_str(), senders_[i].port));
+      continue;
+    }
+    auto length = std::min(len, recvlens_[i]);
+    memcpy(data, recvbuf_.get() + i * RECV_BUFFER_SIZE, length);
+    host = senders_[i].addr;
+    port = senders_[i].port;
     return length;
   }
-
-  host = remoteEndpoint.addr;
-  port = remoteEndpoint.port;
-  return length;
 }
 
 ssize_t DHTConnectionImpl::sendMessage(const unsigned char* data, size_t len,
@@ -38,8 +38,11 @@
 #include "DHTConnection.h"
 
 #include <memory>
+#include <array>
 
 #include "SegList.h"
+#include "a2netcompat.h"
+#include "a2functional.h"
 
 namespace aria2 {
 
@@ -51,6 +54,21 @@ private:
 
   int family_;
 
+  // The number of datagrams read from socket_ at once.
+  static constexpr size_t RECV_BATCH_SIZE = 16;
+
+  // The maximum size of the datagram we accept.  DHT messages and UDP
+  // tracker responses are much smaller than this.
+  static constexpr size_t RECV_BUFFER_SIZE = 8_k;
+
+  // Datagrams read from socket_ but not yet passed to caller.  They
+  // are stored in recvbuf_ at RECV_BUFFER_SIZE interval.
+  std::unique_ptr<unsigned char[]> recvbuf_;
+  std::array<size_t, RECV_BATCH_SIZE> recvlens_;
+  std::array<Endpoint, RECV_BATCH_SIZE> senders_;
+  size_t numRecv_;
+  size_t nextRecv_;
+
 public:
   DHTConnectionImpl(int family);
 
@@ -64,6 +64,20 @@ constexpr auto DHT_PEER_ANNOUNCE_INTERVAL = 15_min;
 
 constexpr auto DHT_PEER_ANNOUNCE_CHECK_INTERVAL = 5_min;
 
+// The maximum number of peers stored for each info hash.  If it is
+// reached, the peer which has not announced for the longest time is
+// dropped.
+constexpr size_t DHT_MAX_PEER_ADDR_ENTRIES = 128;
+
+// The maximum number of info hashes stored in
+// DHTPeerAnnounceStorage.  If it is reached, the info hash which has
+// not been updated for the longest time is dropped.
+constexpr size_t DHT_MAX_PEER_ANNOUNCE_ENTRIES = 1024;
+
+// The maximum number of peers returned in get_peers reply.  See
+// DHTGetPeersReplyMessage::getResponse() for the reason.
+constexpr size_t DHT_MAX_VALUES_SIZE = 25;
+
 constexpr auto DHT_TOKEN_UPDATE_INTERVAL = 10_min;
 
 } // namespace aria2
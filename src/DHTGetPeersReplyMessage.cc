@@ -124,11 +124,12 @@ std::unique_ptr<Dict> DHTGetPeersReplyMessage::getResponse()
     // can carry (1024-28-395)/(18+3) = 28 peer info. Since DHT spec
     // doesn't specify the maximum size of token, reply message
     // template may get bigger than 395 bytes. So we use 25 as maximum
-    // number of peer info that a message can carry.
-    constexpr size_t MAX_VALUES_SIZE = 25;
+    // number of peer info that a message can carry.  See
+    // DHT_MAX_VALUES_SIZE.
     auto valuesList = List::g();
     for (auto i = std::begin(values_);
-         i != std::end(values_) && valuesList->size() < MAX_VALUES_SIZE; ++i) {
+         i != std::end(values_) && valuesList->size() < DHT_MAX_VALUES_SIZE;
+         ++i) {
       std::array<unsigned char, COMPACT_LEN_IPV6> compact;
       const auto clen = bittorrent::getCompactLength(family_);
       auto compactlen = bittorrent::packcompact(
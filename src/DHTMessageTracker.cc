@@ -35,6 +35,7 @@
 #include "DHTMessageTracker.h"
 
 #include <utility>
+#include <algorithm>
 
 #include "DHTMessage.h"
 #include "DHTMessageCallback.h"
@@ -48,6 +49,7 @@
 #include "DlAbortEx.h"
 #include "DHTConstants.h"
 #include "fmt.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -60,9 +62,13 @@ void DHTMessageTracker::addMessage(DHTMessage* message,
                                    std::chrono::seconds timeout,
                                    std::unique_ptr<DHTMessageCallback> callback)
 {
-  entries_.push_back(make_unique<DHTMessageTrackerEntry>(
+  auto entry = make_unique<DHTMessageTrackerEntry>(
       message->getRemoteNode(), message->getTransactionID(),
-      message->getMessageType(), std::move(timeout), std::move(callback)));
+      message->getMessageType(), std::move(timeout), std::move(callback));
+  timeoutHeap_.push_back(TimeoutItem{entry->getDeadline(),
+                                     message->getTransactionID(), entry.get()});
+  std::push_heap(std::begin(timeoutHeap_), std::end(timeoutHeap_));
+  entries_.emplace(message->getTransactionID(), std::move(entry));
 }
 
 std::pair<std::unique_ptr<DHTResponseMessage>,
@@ -77,9 +83,10 @@ DHTMessageTracker::messageArrived(const Dict* dict, const std::string& ipaddr,
   }
   A2_LOG_DEBUG(fmt("Searching tracker entry for TransactionID=%s, Remote=%s:%u",
                    util::toHex(tid->s()).c_str(), ipaddr.c_str(), port));
-  for (auto i = std::begin(entries_), eoi = std::end(entries_); i != eoi; ++i) {
-    if ((*i)->match(tid->s(), ipaddr, port)) {
-      auto entry = std::move(*i);
+  auto range = entries_.equal_range(tid->s());
+  for (auto i = range.first; i != range.second; ++i) {
+    if ((*i).second->match(tid->s(), ipaddr, port)) {
+      auto entry = std::move((*i).second);
       entries_.erase(i);
       A2_LOG_DEBUG("Tracker entry found.");
       auto& targetNode = entry->getTargetNode();
@@ -142,28 +149,36 @@ void DHTMessageTracker::handleTimeoutEntry(DHTMessageTrackerEntry* entry)
 
 void DHTMessageTracker::handleTimeout()
 {
-  entries_.erase(
-      std::remove_if(std::begin(entries_), std::end(entries_),
-                     [&](const std::unique_ptr<DHTMessageTrackerEntry>& ent) {
-                       if (ent->isTimeout()) {
-                         handleTimeoutEntry(ent.get());
-                         return true;
-                       }
-                       else {
-                         return false;
-                       }
-                     }),
-      std::end(entries_));
+  while (!timeoutHeap_.empty() &&
+         timeoutHeap_.front().deadline <= global::wallclock()) {
+    std::pop_heap(std::begin(timeoutHeap_), std::end(timeoutHeap_));
+    auto item = std::move(timeoutHeap_.back());
+    timeoutHeap_.pop_back();
+    // The entry may have been removed already by messageArrived().
+    // Comparing deadline guards against a new entry which happens to
+    // be allocated at the same address.
+    auto range = entries_.equal_range(item.transactionID);
+    for (auto i = range.first; i != range.second; ++i) {
+      if ((*i).second.get() == item.entry &&
+          !(item.deadline < (*i).second->getDeadline())) {
+        auto entry = std::move((*i).second);
+        entries_.erase(i);
+        handleTimeoutEntry(entry.get());
+        break;
+      }
+    }
+  }
 }
 
 const DHTMessageTrackerEntry*
 DHTMessageTracker::getEntryFor(const DHTMessage* message) const
 {
-  for (auto& ent : entries_) {
-    if (ent->match(message->getTransactionID(),
-                   message->getRemoteNode()->getIPAddress(),
-                   message->getRemoteNode()->getPort())) {
-      return ent.get();
+  auto range = entries_.equal_range(message->getTransactionID());
+  for (auto i = range.first; i != range.second; ++i) {
+    if ((*i).second->match(message->getTransactionID(),
+                           message->getRemoteNode()->getIPAddress(),
+                           message->getRemoteNode()->getPort())) {
+      return (*i).second.get();
     }
   }
   return nullptr;
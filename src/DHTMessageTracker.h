@@ -38,10 +38,12 @@
 #include "common.h"
 
 #include <utility>
-#include <deque>
+#include <vector>
 #include <memory>
+#include <unordered_map>
 
 #include "a2time.h"
+#include "TimerA2.h"
 #include "ValueBase.h"
 
 namespace aria2 {
@@ -55,7 +57,27 @@ class DHTMessageTrackerEntry;
 
 class DHTMessageTracker {
 private:
-  std::deque<std::unique_ptr<DHTMessageTrackerEntry>> entries_;
+  // Entries keyed by transaction ID.  Transaction IDs are short, so
+  // different remote nodes may share the same one; the entry is
+  // matched against the sender's address too.
+  std::unordered_multimap<std::string, std::unique_ptr<DHTMessageTrackerEntry>>
+      entries_;
+
+  struct TimeoutItem {
+    Timer deadline;
+    std::string transactionID;
+    const DHTMessageTrackerEntry* entry;
+    bool operator<(const TimeoutItem& rhs) const
+    {
+      // Reversed so that std::push_heap builds a min-heap.
+      return rhs.deadline < deadline;
+    }
+  };
+
+  // Min-heap of entry deadlines.  Items of entries which have already
+  // got a response are not removed here; they are just skipped when
+  // they reach the top of the heap.
+  std::vector<TimeoutItem> timeoutHeap_;
 
   DHTRoutingTable* routingTable_;
 
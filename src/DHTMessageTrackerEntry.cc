@@ -60,6 +60,13 @@ bool DHTMessageTrackerEntry::isTimeout() const
   return dispatchedTime_.difference(global::wallclock()) >= timeout_;
 }
 
+Timer DHTMessageTrackerEntry::getDeadline() const
+{
+  auto deadline = dispatchedTime_;
+  deadline.advance(timeout_);
+  return deadline;
+}
+
 void DHTMessageTrackerEntry::extendTimeout() {}
 
 bool DHTMessageTrackerEntry::match(const std::string& transactionID,
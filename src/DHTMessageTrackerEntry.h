@@ -72,6 +72,9 @@ public:
 
   bool isTimeout() const;
 
+  // Returns the time at which this entry times out.
+  Timer getDeadline() const;
+
   void extendTimeout();
 
   bool match(const std::string& transactionID, const std::string& ipaddr,
@@ -52,11 +52,22 @@ DHTPeerAnnounceEntry::~DHTPeerAnnounceEntry() = default;
 void DHTPeerAnnounceEntry::addPeerAddrEntry(const PeerAddrEntry& entry)
 {
   auto i = std::find(peerAddrEntries_.begin(), peerAddrEntries_.end(), entry);
-  if (i == peerAddrEntries_.end()) {
+  if (i != peerAddrEntries_.end()) {
+    (*i).notifyUpdate();
+  }
+  else if (peerAddrEntries_.size() < DHT_MAX_PEER_ADDR_ENTRIES) {
     peerAddrEntries_.push_back(entry);
   }
   else {
-    (*i).notifyUpdate();
+    auto oldest = std::min_element(
+        std::begin(peerAddrEntries_), std::end(peerAddrEntries_),
+        [](const PeerAddrEntry& lhs, const PeerAddrEntry& rhs) {
+          return lhs.getLastUpdated() < rhs.getLastUpdated();
+        });
+    // Keep the insertion order, so that getPeers() returns the
+    // newcomer.
+    peerAddrEntries_.erase(oldest);
+    peerAddrEntries_.push_back(entry);
   }
   notifyUpdate();
 }
@@ -80,11 +91,16 @@ void DHTPeerAnnounceEntry::removeStalePeerAddrEntry(
 
 bool DHTPeerAnnounceEntry::empty() const { return peerAddrEntries_.empty(); }
 
-void DHTPeerAnnounceEntry::getPeers(
-    std::vector<std::shared_ptr<Peer>>& peers) const
+void DHTPeerAnnounceEntry::getPeers(std::vector<std::shared_ptr<Peer>>& peers,
+                                    size_t maxPeers) const
 {
-  for (const auto& p : peerAddrEntries_) {
-    peers.push_back(std::make_shared<Peer>(p.getIPAddress(), p.getPort()));
+  auto first = std::begin(peerAddrEntries_);
+  if (peerAddrEntries_.size() > maxPeers) {
+    first = std::end(peerAddrEntries_) - maxPeers;
+  }
+  for (auto i = first, eoi = std::end(peerAddrEntries_); i != eoi; ++i) {
+    peers.push_back(
+        std::make_shared<Peer>((*i).getIPAddress(), (*i).getPort()));
   }
 }
 
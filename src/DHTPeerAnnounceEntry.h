@@ -62,7 +62,9 @@ public:
   ~DHTPeerAnnounceEntry();
 
   // add peer addr entry.
-  // if it already exists, update "Last Updated" property.
+  // if it already exists, update "Last Updated" property.  If
+  // DHT_MAX_PEER_ADDR_ENTRIES entries are already stored, the one
+  // which has not been updated for the longest time is replaced.
   void addPeerAddrEntry(const PeerAddrEntry& entry);
 
   size_t countPeerAddrEntry() const;
@@ -82,7 +84,10 @@ public:
 
   const unsigned char* getInfoHash() const { return infoHash_; }
 
-  void getPeers(std::vector<std::shared_ptr<Peer>>& peers) const;
+  // Appends at most maxPeers peers to peers.  The most recently added
+  // peers are chosen.
+  void getPeers(std::vector<std::shared_ptr<Peer>>& peers,
+                size_t maxPeers = DHT_MAX_PEER_ADDR_ENTRIES) const;
 };
 
 } // namespace aria2
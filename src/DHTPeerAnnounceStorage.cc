@@ -35,7 +35,7 @@
 #include "DHTPeerAnnounceStorage.h"
 
 #include <cstring>
-#include <algorithm>
+#include <iterator>
 
 #include "DHTPeerAnnounceEntry.h"
 #include "Peer.h"
@@ -57,28 +57,41 @@ DHTPeerAnnounceStorage::DHTPeerAnnounceStorage()
 {
 }
 
-bool DHTPeerAnnounceStorage::InfoHashLess::operator()(
-    const std::shared_ptr<DHTPeerAnnounceEntry>& lhs,
-    const std::shared_ptr<DHTPeerAnnounceEntry>& rhs) const
+DHTPeerAnnounceStorage::~DHTPeerAnnounceStorage() = default;
+
+namespace {
+std::array<unsigned char, DHT_ID_LENGTH> toKey(const unsigned char* infoHash)
 {
-  return memcmp(lhs->getInfoHash(), rhs->getInfoHash(), DHT_ID_LENGTH) < 0;
+  std::array<unsigned char, DHT_ID_LENGTH> key;
+  memcpy(key.data(), infoHash, DHT_ID_LENGTH);
+  return key;
 }
+} // namespace
 
-std::shared_ptr<DHTPeerAnnounceEntry>
+DHTPeerAnnounceEntry*
 DHTPeerAnnounceStorage::getPeerAnnounceEntry(const unsigned char* infoHash)
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
-
-  auto i = entries_.lower_bound(entry);
-
-  if (i != entries_.end() &&
-      memcmp(infoHash, (*i)->getInfoHash(), DHT_ID_LENGTH) == 0) {
-    entry = *i;
+  auto key = toKey(infoHash);
+  auto i = index_.lower_bound(key);
+  if (i != std::end(index_) && (*i).first == key) {
+    entries_.splice(std::end(entries_), entries_, (*i).second);
+    return (*i).second->get();
   }
-  else {
-    entries_.insert(i, entry);
+  if (index_.size() >= DHT_MAX_PEER_ANNOUNCE_ENTRIES) {
+    auto& oldest = entries_.front();
+    A2_LOG_DEBUG(fmt("Too many peer announce entries. Dropping infoHash=%s",
+                     util::toHex(oldest->getInfoHash(), DHT_ID_LENGTH)
+                         .c_str()));
+    auto j = index_.find(toKey(oldest->getInfoHash()));
+    if (j == i) {
+      ++i;
+    }
+    index_.erase(j);
+    entries_.pop_front();
   }
-  return entry;
+  entries_.push_back(make_unique<DHTPeerAnnounceEntry>(infoHash));
+  index_.insert(i, std::make_pair(key, std::prev(std::end(entries_))));
+  return entries_.back().get();
 }
 
 void DHTPeerAnnounceStorage::addPeerAnnounce(const unsigned char* infoHash,
@@ -93,19 +106,15 @@ void DHTPeerAnnounceStorage::addPeerAnnounce(const unsigned char* infoHash,
 
 bool DHTPeerAnnounceStorage::contains(const unsigned char* infoHash) const
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
-  return std::binary_search(entries_.begin(), entries_.end(), entry,
-                            InfoHashLess());
+  return index_.count(toKey(infoHash));
 }
 
 void DHTPeerAnnounceStorage::getPeers(std::vector<std::shared_ptr<Peer>>& peers,
                                       const unsigned char* infoHash)
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
-
-  auto i = entries_.find(entry);
-  if (i != entries_.end()) {
-    (*i)->getPeers(peers);
+  auto i = index_.find(toKey(infoHash));
+  if (i != std::end(index_)) {
+    (*(*i).second)->getPeers(peers, DHT_MAX_VALUES_SIZE);
   }
 }
 
@@ -113,14 +122,11 @@ void DHTPeerAnnounceStorage::handleTimeout()
 {
   A2_LOG_DEBUG(fmt("Now purge peer announces(%lu entries) which are timed out.",
                    static_cast<unsigned long>(entries_.size())));
-  std::for_each(std::begin(entries_), std::end(entries_),
-                [](const std::shared_ptr<DHTPeerAnnounceEntry>& e) {
-                  e->removeStalePeerAddrEntry(DHT_PEER_ANNOUNCE_PURGE_INTERVAL);
-                });
-
   for (auto i = std::begin(entries_); i != std::end(entries_);) {
+    (*i)->removeStalePeerAddrEntry(DHT_PEER_ANNOUNCE_PURGE_INTERVAL);
     if ((*i)->empty()) {
-      entries_.erase(i++);
+      index_.erase(toKey((*i)->getInfoHash()));
+      i = entries_.erase(i);
     }
     else {
       ++i;
@@ -133,16 +139,21 @@ void DHTPeerAnnounceStorage::handleTimeout()
 void DHTPeerAnnounceStorage::announcePeer()
 {
   A2_LOG_DEBUG("Now announcing peer.");
-  for (auto& e : entries_) {
+  // entries_ is ordered by the last update, so stop at the first
+  // entry updated recently.  Announced entries are moved to the end
+  // and stop the loop as well.
+  while (!entries_.empty()) {
+    auto& e = entries_.front();
     if (e->getLastUpdated().difference(global::wallclock()) <
         DHT_PEER_ANNOUNCE_INTERVAL) {
-      continue;
+      break;
     }
     e->notifyUpdate();
     auto task = taskFactory_->createPeerAnnounceTask(e->getInfoHash());
     taskQueue_->addPeriodicTask2(task);
     A2_LOG_DEBUG(fmt("Added 1 peer announce: infoHash=%s",
                      util::toHex(e->getInfoHash(), DHT_ID_LENGTH).c_str()));
+    entries_.splice(std::end(entries_), entries_, std::begin(entries_));
   }
 }
 
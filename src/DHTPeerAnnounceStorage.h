@@ -37,11 +37,15 @@
 
 #include "common.h"
 
-#include <set>
+#include <map>
+#include <list>
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
 
+#include "DHTConstants.h"
+
 namespace aria2 {
 
 class Peer;
@@ -51,17 +55,23 @@ class DHTTaskFactory;
 
 class DHTPeerAnnounceStorage {
 private:
-  class InfoHashLess {
-  public:
-    bool operator()(const std::shared_ptr<DHTPeerAnnounceEntry>& lhs,
-                    const std::shared_ptr<DHTPeerAnnounceEntry>& rhs) const;
-  };
-  typedef std::set<std::shared_ptr<DHTPeerAnnounceEntry>, InfoHashLess>
-      DHTPeerAnnounceEntrySet;
-  DHTPeerAnnounceEntrySet entries_;
-
-  std::shared_ptr<DHTPeerAnnounceEntry>
-  getPeerAnnounceEntry(const unsigned char* infoHash);
+  typedef std::array<unsigned char, DHT_ID_LENGTH> InfoHash;
+  typedef std::list<std::unique_ptr<DHTPeerAnnounceEntry>>
+      DHTPeerAnnounceEntryList;
+  // Entries in the order of the last update, the least recently
+  // updated one first.
+  DHTPeerAnnounceEntryList entries_;
+  typedef std::map<InfoHash, DHTPeerAnnounceEntryList::iterator>
+      DHTPeerAnnounceEntryIndex;
+  // Index of entries_ by infoHash.
+  DHTPeerAnnounceEntryIndex index_;
+
+  // Returns the entry for infoHash and moves it to the end of
+  // entries_, since the caller is about to update it.  If it does
+  // not exist, new entry is created.  If the number of entries
+  // reaches DHT_MAX_PEER_ANNOUNCE_ENTRIES, the entry which has not
+  // been updated for the longest time is dropped to make room.
+  DHTPeerAnnounceEntry* getPeerAnnounceEntry(const unsigned char* infoHash);
 
   DHTTaskQueue* taskQueue_;
 
@@ -70,11 +80,17 @@ private:
 public:
   DHTPeerAnnounceStorage();
 
+  ~DHTPeerAnnounceStorage();
+
   void addPeerAnnounce(const unsigned char* infoHash, const std::string& ipaddr,
                        uint16_t port);
 
   bool contains(const unsigned char* infoHash) const;
 
+  size_t countEntry() const { return index_.size(); }
+
+  // Appends at most DHT_MAX_VALUES_SIZE peers announced for infoHash
+  // to peers.
   void getPeers(std::vector<std::shared_ptr<Peer>>& peers,
                 const unsigned char* infoHash);
 
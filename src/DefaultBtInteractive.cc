@@ -35,6 +35,7 @@
 #include "DefaultBtInteractive.h"
 
 #include <cstring>
+#include <algorithm>
 #include <vector>
 
 #include "prefs.h"
@@ -104,6 +105,9 @@ DefaultBtInteractive::DefaultBtInteractive(
       dhtEnabled_(false),
       numReceivedMessage_(0),
       maxOutstandingRequest_(DEFAULT_MAX_OUTSTANDING_REQUEST),
+      superSeeding_(false),
+      superSeedingIndex_(0),
+      superSeedingOffered_(false),
       requestGroupMan_(nullptr),
       tcpPort_(0)
 {
@@ -175,6 +179,11 @@ void DefaultBtInteractive::doPostHandshakeProcessing()
   keepAliveTimer_ = global::wallclock();
   floodingTimer_ = global::wallclock();
   pexTimer_ = Timer::zero();
+  // Super-seeding only makes sense if we have all pieces.
+  if (superSeeding_ &&
+      (metadataGetMode_ || !pieceStorage_->allDownloadFinished())) {
+    superSeeding_ = false;
+  }
   if (peer_->isExtendedMessagingEnabled()) {
     addHandshakeExtendedMessageToQueue();
   }
@@ -184,7 +193,7 @@ void DefaultBtInteractive::doPostHandshakeProcessing()
   if (peer_->isDHTEnabled() && dhtEnabled_) {
     addPortMessageToQueue();
   }
-  if (!metadataGetMode_) {
+  if (!metadataGetMode_ && !superSeeding_) {
     addAllowedFastMessageToQueue();
   }
   sendPendingMessage();
@@ -212,6 +221,14 @@ void DefaultBtInteractive::addHandshakeExtendedMessageToQueue()
 
 void DefaultBtInteractive::addBitfieldMessageToQueue()
 {
+  if (superSeeding_) {
+    // Pretend to have nothing.  Pieces are advertised one by one with
+    // HAVE messages.
+    if (peer_->isFastExtensionEnabled()) {
+      dispatcher_->addMessageToQueue(messageFactory_->createHaveNoneMessage());
+    }
+    return;
+  }
   if (peer_->isFastExtensionEnabled()) {
     if (pieceStorage_->allDownloadFinished()) {
       dispatcher_->addMessageToQueue(messageFactory_->createHaveAllMessage());
@@ -264,11 +281,28 @@ void DefaultBtInteractive::decideChoking()
 
 void DefaultBtInteractive::checkHave()
 {
+  if (superSeeding_) {
+    checkSuperSeedingHave();
+    return;
+  }
   std::vector<size_t> haveIndexes;
 
   lastHaveIndex_ = pieceStorage_->getAdvertisedPieceIndexes(haveIndexes, cuid_,
                                                             lastHaveIndex_);
 
+  // Don't tell the peer about pieces it already has.  In a large
+  // swarm most HAVE messages sent to seeders and nearly finished
+  // peers are redundant.
+  haveIndexes.erase(std::remove_if(std::begin(haveIndexes),
+                                   std::end(haveIndexes),
+                                   [this](size_t index) {
+                                     return peer_->hasPiece(index);
+                                   }),
+                    std::end(haveIndexes));
+  if (haveIndexes.empty()) {
+    return;
+  }
+
   // Use bitfield message if it is equal to or less than the total
   // size of have messages.
   if (5 + pieceStorage_->getBitfieldLength() <= haveIndexes.size() * 9) {
@@ -289,6 +323,23 @@ void DefaultBtInteractive::checkHave()
   }
 }
 
+void DefaultBtInteractive::checkSuperSeedingHave()
+{
+  // Advertise the next piece only after the peer has downloaded the
+  // previous one.
+  if (superSeedingOffered_ && !peer_->hasPiece(superSeedingIndex_)) {
+    return;
+  }
+  superSeedingOffered_ =
+      pieceStorage_->getSuperSeedingPieceIndex(superSeedingIndex_, peer_);
+  if (superSeedingOffered_) {
+    A2_LOG_DEBUG(fmt("CUID#%" PRId64 " - Super-seeding: advertise piece %lu",
+                     cuid_, static_cast<unsigned long>(superSeedingIndex_)));
+    dispatcher_->addMessageToQueue(
+        messageFactory_->createHaveMessage(superSeedingIndex_));
+  }
+}
+
 void DefaultBtInteractive::sendKeepAlive()
 {
   if (keepAliveTimer_.difference(global::wallclock()) >= keepAliveInterval_) {
@@ -338,13 +389,16 @@ size_t DefaultBtInteractive::receiveMessages()
     }
   }
 
-  if (!pieceStorage_->isEndGame() &&
+  // Slow start: grow the window quickly until the download speed of
+  // this peer is measured.  After that, updateMaxOutstandingRequest()
+  // sizes it from the bandwidth-delay product.
+  if (!pieceStorage_->isEndGame() && peer_->calculateDownloadSpeed() == 0 &&
       countOldOutstandingRequest > dispatcher_->countOutstandingRequest() &&
       (countOldOutstandingRequest - dispatcher_->countOutstandingRequest()) *
               4 >=
           maxOutstandingRequest_) {
-    maxOutstandingRequest_ = std::min((size_t)UB_MAX_OUTSTANDING_REQUEST,
-                                      maxOutstandingRequest_ * 2);
+    maxOutstandingRequest_ =
+        std::min(getOutstandingRequestLimit(), maxOutstandingRequest_ * 2);
   }
   return msgcount;
 }
@@ -411,6 +465,37 @@ void DefaultBtInteractive::fillPiece(size_t maxMissingBlock)
   }
 }
 
+namespace {
+// The number of seconds worth of blocks we keep requested from a
+// peer.  This must be longer than the round trip time to the peer,
+// otherwise the pipe drains while the next requests are in flight.
+constexpr size_t REQUEST_QUEUE_TIME = 3;
+} // namespace
+
+size_t DefaultBtInteractive::getOutstandingRequestLimit() const
+{
+  auto limit = peer_->getMaxRequestQueue();
+  if (limit == 0 || limit > UB_MAX_OUTSTANDING_REQUEST) {
+    return UB_MAX_OUTSTANDING_REQUEST;
+  }
+  return limit;
+}
+
+void DefaultBtInteractive::updateMaxOutstandingRequest()
+{
+  auto limit = getOutstandingRequestLimit();
+  auto speed = peer_->calculateDownloadSpeed();
+  if (speed > 0) {
+    // Keep the bandwidth-delay product of this peer requested.
+    auto n = static_cast<size_t>(speed) * REQUEST_QUEUE_TIME /
+             Piece::BLOCK_LENGTH;
+    maxOutstandingRequest_ = std::max(n, DEFAULT_MAX_OUTSTANDING_REQUEST);
+  }
+  // Otherwise nothing has been measured yet, and the value grown in
+  // receiveMessages() is kept.
+  maxOutstandingRequest_ = std::min(maxOutstandingRequest_, limit);
+}
+
 void DefaultBtInteractive::addRequests()
 {
   if (!pieceStorage_->isEndGame() && !pieceStorage_->hasMissingUnusedPiece()) {
@@ -566,6 +651,12 @@ void DefaultBtInteractive::doInteractionProcessing()
     if (perSecTimer_.difference(global::wallclock()) >= 1_s) {
       perSecTimer_ = global::wallclock();
       dispatcher_->checkRequestSlotAndDoNecessaryThing();
+      updateMaxOutstandingRequest();
+    }
+    else if (pieceStorage_->isEndGame()) {
+      // In end game mode, the same block is requested from several
+      // peers.  Cancel the duplicates as soon as one of them arrives.
+      dispatcher_->checkRequestSlotAndDoNecessaryThing();
     }
     numReceivedMessage_ = receiveMessages();
     detectMessageFlooding();
@@ -142,6 +142,12 @@ private:
 
   size_t maxOutstandingRequest_;
 
+  bool superSeeding_;
+  // The piece advertised to the peer in super-seeding mode.  Valid
+  // only if superSeedingOffered_ is true.
+  size_t superSeedingIndex_;
+  bool superSeedingOffered_;
+
   RequestGroupMan* requestGroupMan_;
 
   uint16_t tcpPort_;
@@ -151,10 +157,13 @@ private:
   void addHandshakeExtendedMessageToQueue();
   void decideChoking();
   void checkHave();
+  void checkSuperSeedingHave();
   void sendKeepAlive();
   void decideInterest();
   void fillPiece(size_t maxMissingBlock);
   void addRequests();
+  size_t getOutstandingRequestLimit() const;
+  void updateMaxOutstandingRequest();
   void detectMessageFlooding();
   void checkActiveInteraction();
   void addPeerExchangeMessage();
@@ -229,6 +238,8 @@ public:
 
   void setDHTEnabled(bool f) { dhtEnabled_ = f; }
 
+  void setSuperSeeding(bool f) { superSeeding_ = f; }
+
   void setRequestGroupMan(RequestGroupMan* rgman);
 
   void setUTMetadataRequestTracker(
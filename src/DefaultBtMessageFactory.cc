@@ -99,6 +99,9 @@ DefaultBtMessageFactory::createBtMessage(const unsigned char* data,
   }
   else {
     uint8_t id = bittorrent::getId(data);
+    // Messages are validated here with validators on the stack
+    // instead of heap-allocated validator objects.  The message
+    // object itself is still allocated on the heap.
     switch (id) {
     case BtChokeMessage::ID:
       msg = BtChokeMessage::create(data, dataLength);
@@ -118,29 +121,30 @@ DefaultBtMessageFactory::createBtMessage(const unsigned char* data,
       msg = std::move(m);
       break;
     }
-    case BtHaveMessage::ID:
-      msg = BtHaveMessage::create(data, dataLength);
+    case BtHaveMessage::ID: {
+      auto m = BtHaveMessage::create(data, dataLength);
       if (!metadataGetMode_) {
-        msg->setBtMessageValidator(make_unique<IndexBtMessageValidator>(
-            static_cast<BtHaveMessage*>(msg.get()),
-            downloadContext_->getNumPieces()));
+        IndexBtMessageValidator(m.get(), downloadContext_->getNumPieces())
+            .validate();
       }
+      msg = std::move(m);
       break;
-    case BtBitfieldMessage::ID:
-      msg = BtBitfieldMessage::create(data, dataLength);
+    }
+    case BtBitfieldMessage::ID: {
+      auto m = BtBitfieldMessage::create(data, dataLength);
       if (!metadataGetMode_) {
-        msg->setBtMessageValidator(make_unique<BtBitfieldMessageValidator>(
-            static_cast<BtBitfieldMessage*>(msg.get()),
-            downloadContext_->getNumPieces()));
+        BtBitfieldMessageValidator(m.get(), downloadContext_->getNumPieces())
+            .validate();
       }
+      msg = std::move(m);
       break;
+    }
     case BtRequestMessage::ID: {
       auto m = BtRequestMessage::create(data, dataLength);
       if (!metadataGetMode_) {
-        m->setBtMessageValidator(make_unique<RangeBtMessageValidator>(
-            static_cast<BtRequestMessage*>(m.get()),
-            downloadContext_->getNumPieces(),
-            pieceStorage_->getPieceLength(m->getIndex())));
+        RangeBtMessageValidator(m.get(), downloadContext_->getNumPieces(),
+                                pieceStorage_->getPieceLength(m->getIndex()))
+            .validate();
       }
       msg = std::move(m);
       break;
@@ -148,10 +152,9 @@ DefaultBtMessageFactory::createBtMessage(const unsigned char* data,
     case BtPieceMessage::ID: {
       auto m = BtPieceMessage::create(data, dataLength);
       if (!metadataGetMode_) {
-        m->setBtMessageValidator(make_unique<BtPieceMessageValidator>(
-            static_cast<BtPieceMessage*>(m.get()),
-            downloadContext_->getNumPieces(),
-            pieceStorage_->getPieceLength(m->getIndex())));
+        BtPieceMessageValidator(m.get(), downloadContext_->getNumPieces(),
+                                pieceStorage_->getPieceLength(m->getIndex()))
+            .validate();
       }
       m->setDownloadContext(downloadContext_);
       m->setPeerStorage(peerStorage_);
@@ -161,10 +164,9 @@ DefaultBtMessageFactory::createBtMessage(const unsigned char* data,
     case BtCancelMessage::ID: {
       auto m = BtCancelMessage::create(data, dataLength);
       if (!metadataGetMode_) {
-        m->setBtMessageValidator(make_unique<RangeBtMessageValidator>(
-            static_cast<BtCancelMessage*>(m.get()),
-            downloadContext_->getNumPieces(),
-            pieceStorage_->getPieceLength(m->getIndex())));
+        RangeBtMessageValidator(m.get(), downloadContext_->getNumPieces(),
+                                pieceStorage_->getPieceLength(m->getIndex()))
+            .validate();
       }
       msg = std::move(m);
       break;
@@ -181,9 +183,8 @@ DefaultBtMessageFactory::createBtMessage(const unsigned char* data,
     case BtSuggestPieceMessage::ID: {
       auto m = BtSuggestPieceMessage::create(data, dataLength);
       if (!metadataGetMode_) {
-        m->setBtMessageValidator(make_unique<IndexBtMessageValidator>(
-            static_cast<BtSuggestPieceMessage*>(m.get()),
-            downloadContext_->getNumPieces()));
+        IndexBtMessageValidator(m.get(), downloadContext_->getNumPieces())
+            .validate();
       }
       msg = std::move(m);
       break;
@@ -197,10 +198,9 @@ DefaultBtMessageFactory::createBtMessage(const unsigned char* data,
     case BtRejectMessage::ID: {
       auto m = BtRejectMessage::create(data, dataLength);
       if (!metadataGetMode_) {
-        m->setBtMessageValidator(make_unique<RangeBtMessageValidator>(
-            static_cast<BtRejectMessage*>(m.get()),
-            downloadContext_->getNumPieces(),
-            pieceStorage_->getPieceLength(m->getIndex())));
+        RangeBtMessageValidator(m.get(), downloadContext_->getNumPieces(),
+                                pieceStorage_->getPieceLength(m->getIndex()))
+            .validate();
       }
       msg = std::move(m);
       break;
@@ -208,9 +208,8 @@ DefaultBtMessageFactory::createBtMessage(const unsigned char* data,
     case BtAllowedFastMessage::ID: {
       auto m = BtAllowedFastMessage::create(data, dataLength);
       if (!metadataGetMode_) {
-        m->setBtMessageValidator(make_unique<IndexBtMessageValidator>(
-            static_cast<BtAllowedFastMessage*>(m.get()),
-            downloadContext_->getNumPieces()));
+        IndexBtMessageValidator(m.get(), downloadContext_->getNumPieces())
+            .validate();
       }
       msg = std::move(m);
       break;
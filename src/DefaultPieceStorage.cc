@@ -375,6 +375,32 @@ std::shared_ptr<Piece> DefaultPieceStorage::getMissingFastPiece(
   }
 }
 
+bool DefaultPieceStorage::getSuperSeedingPieceIndex(
+    size_t& index, const std::shared_ptr<Peer>& peer)
+{
+  size_t numPieces = bitfieldMan_->countBlock();
+  if (superSeedingCounts_.empty()) {
+    superSeedingCounts_.resize(numPieces);
+  }
+  const auto& counts = pieceStatMan_->getCounts();
+  bool found = false;
+  for (size_t i = 0; i < numPieces; ++i) {
+    if (!bitfieldMan_->isBitSet(i) || peer->hasPiece(i)) {
+      continue;
+    }
+    if (!found ||
+        std::make_pair(superSeedingCounts_[i], counts[i]) <
+            std::make_pair(superSeedingCounts_[index], counts[index])) {
+      index = i;
+      found = true;
+    }
+  }
+  if (found) {
+    ++superSeedingCounts_[index];
+  }
+  return found;
+}
+
 #endif // ENABLE_BITTORRENT
 
 bool DefaultPieceStorage::hasMissingUnusedPiece()
@@ -651,6 +677,8 @@ void DefaultPieceStorage::initStorage()
     multiDiskAdaptor->setFileEntries(downloadContext_->getFileEntries().begin(),
                                      downloadContext_->getFileEntries().end());
     multiDiskAdaptor->setPieceLength(downloadContext_->getPieceLength());
+    multiDiskAdaptor->setFileAllocationThreads(
+        option_->getAsInt(PREF_FILE_ALLOCATION_THREADS));
     diskAdaptor_ = std::move(multiDiskAdaptor);
   }
   if (option_->get(PREF_FILE_ALLOCATION) == V_FALLOC) {
@@ -91,6 +91,10 @@ private:
 
   std::shared_ptr<PieceStatMan> pieceStatMan_;
 
+  // The number of times each piece was advertised in super-seeding
+  // mode.  Allocated on first use.
+  std::vector<int> superSeedingCounts_;
+
   std::unique_ptr<PieceSelector> pieceSelector_;
   std::unique_ptr<StreamPieceSelector> streamPieceSelector_;
 
@@ -169,6 +173,10 @@ public:
   getMissingFastPiece(const std::shared_ptr<Peer>& peer,
                       const std::vector<size_t>& excludedIndexes, cuid_t cuid);
 
+  virtual bool
+  getSuperSeedingPieceIndex(size_t& index,
+                            const std::shared_ptr<Peer>& peer) CXX11_OVERRIDE;
+
 #endif // ENABLE_BITTORRENT
 
   virtual bool hasMissingUnusedPiece() CXX11_OVERRIDE;
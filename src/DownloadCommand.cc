@@ -94,7 +94,7 @@ DownloadCommand::DownloadCommand(
     }
   }
 
-  peerStat_ = req->initPeerStat();
+  peerStat_ = req->initPeerStat(getCuid());
   peerStat_->downloadStart();
   getSegmentMan()->registerPeerStat(peerStat_);
 
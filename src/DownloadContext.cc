@@ -50,6 +50,7 @@ namespace aria2 {
 DownloadContext::DownloadContext()
     : ownerRequestGroup_(nullptr),
       attrs_(MAX_CTX_ATTR),
+      pieceHashLength_(0),
       downloadStopTime_(Timer::zero()),
       pieceLength_(0),
       checksumVerified_(false),
@@ -66,6 +67,7 @@ DownloadContext::DownloadContext(int32_t pieceLength, int64_t totalLength,
                                  std::string path)
     : ownerRequestGroup_(nullptr),
       attrs_(MAX_CTX_ATTR),
+      pieceHashLength_(0),
       downloadStopTime_(Timer::zero()),
       pieceLength_(pieceLength),
       checksumVerified_(false),
@@ -270,20 +272,28 @@ bool DownloadContext::isChecksumVerificationAvailable() const
 
 bool DownloadContext::isPieceHashVerificationAvailable() const
 {
-  return !pieceHashType_.empty() && pieceHashes_.size() > 0 &&
-         pieceHashes_.size() == getNumPieces();
+  return !pieceHashType_.empty() && countPieceHash() > 0 &&
+         countPieceHash() == getNumPieces();
 }
 
-const std::string& DownloadContext::getPieceHash(size_t index) const
+std::string DownloadContext::getPieceHash(size_t index) const
 {
-  if (index < pieceHashes_.size()) {
-    return pieceHashes_[index];
+  if (index < countPieceHash()) {
+    return pieceHashData_.substr(index * pieceHashLength_, pieceHashLength_);
   }
   else {
     return A2STR::NIL;
   }
 }
 
+void DownloadContext::setPieceHashes(const std::string& hashType,
+                                     std::string hashData, size_t hashLength)
+{
+  pieceHashType_ = hashType;
+  pieceHashData_ = std::move(hashData);
+  pieceHashLength_ = hashLength;
+}
+
 void DownloadContext::setDigest(const std::string& hashType,
                                 const std::string& digest)
 {
@@ -304,18 +314,22 @@ void DownloadContext::setSignature(std::unique_ptr<Signature> signature)
 void DownloadContext::updateDownload(size_t bytes)
 {
   netStat_.updateDownload(bytes);
+  ownerRequestGroup_->getDownloadBucket().consume(bytes);
   RequestGroupMan* rgman = ownerRequestGroup_->getRequestGroupMan();
   if (rgman) {
     rgman->getNetStat().updateDownload(bytes);
+    rgman->getDownloadBucket().consume(bytes);
   }
 }
 
 void DownloadContext::updateUploadSpeed(size_t bytes)
 {
   netStat_.updateUploadSpeed(bytes);
+  ownerRequestGroup_->getUploadBucket().consume(bytes);
   auto rgman = ownerRequestGroup_->getRequestGroupMan();
   if (rgman) {
     rgman->getNetStat().updateUploadSpeed(bytes);
+    rgman->getUploadBucket().consume(bytes);
   }
 }
 
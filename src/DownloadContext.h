@@ -65,7 +65,12 @@ private:
 
   std::vector<std::shared_ptr<FileEntry>> fileEntries_;
 
-  std::vector<std::string> pieceHashes_;
+  // Piece hashes concatenated in one buffer, each pieceHashLength_
+  // bytes long.  Torrents with many pieces would otherwise allocate
+  // a string per piece.
+  std::string pieceHashData_;
+
+  size_t pieceHashLength_;
 
   NetStat netStat_;
 
@@ -99,21 +104,40 @@ public:
 
   ~DownloadContext();
 
-  const std::string& getPieceHash(size_t index) const;
+  // Returns the hash of index-th piece, or empty string if there is
+  // no such piece hash.
+  std::string getPieceHash(size_t index) const;
 
-  const std::vector<std::string>& getPieceHashes() const
+  size_t countPieceHash() const
   {
-    return pieceHashes_;
+    return pieceHashLength_ == 0 ? 0 : pieceHashData_.size() / pieceHashLength_;
   }
 
+  // Returns all piece hashes concatenated.  The index-th piece hash
+  // starts at index * getPieceHashLength().
+  const std::string& getPieceHashData() const { return pieceHashData_; }
+
+  size_t getPieceHashLength() const { return pieceHashLength_; }
+
+  // Sets piece hashes from the range [first, last) of strings.  All
+  // of them must have the same length.
   template <typename InputIterator>
   void setPieceHashes(const std::string& hashType, InputIterator first,
                       InputIterator last)
   {
     pieceHashType_ = hashType;
-    pieceHashes_.assign(first, last);
+    pieceHashData_.clear();
+    pieceHashLength_ = first == last ? 0 : (*first).size();
+    for (; first != last; ++first) {
+      pieceHashData_ += *first;
+    }
   }
 
+  // Sets piece hashes from hashData, which contains concatenated
+  // hashes of hashLength bytes each.
+  void setPieceHashes(const std::string& hashType, std::string hashData,
+                      size_t hashLength);
+
   int64_t getTotalLength() const;
 
   bool knowsTotalLength() const { return knowsTotalLength_; }
@@ -85,6 +85,12 @@ bool FileAllocationCommand::executeInternal()
     return true;
   }
   else {
+    if (fileAllocationEntry_->allocatesInBackground()) {
+      // Nothing to do until the worker threads finish, so check them
+      // again at the next refresh of the event loop instead of
+      // spinning it.
+      setStatusInactive();
+    }
     getDownloadEngine()->addCommand(std::unique_ptr<Command>(this));
     return false;
   }
@@ -72,4 +72,9 @@ void FileAllocationEntry::allocateChunk()
   fileAllocationIterator_->allocateChunk();
 }
 
+bool FileAllocationEntry::allocatesInBackground()
+{
+  return fileAllocationIterator_->allocatesInBackground();
+}
+
 } // namespace aria2
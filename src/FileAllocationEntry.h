@@ -68,6 +68,8 @@ public:
 
   void allocateChunk();
 
+  bool allocatesInBackground();
+
   virtual void
   prepareForNextAction(std::vector<std::unique_ptr<Command>>& commands,
                        DownloadEngine* e) = 0;
@@ -52,6 +52,10 @@ public:
   virtual int64_t getCurrentLength() = 0;
 
   virtual int64_t getTotalLength() = 0;
+
+  // Returns true if the allocation is performed outside of
+  // allocateChunk(), which then only checks the progress.
+  virtual bool allocatesInBackground() { return false; }
 };
 
 } // namespace aria2
@@ -414,7 +414,7 @@ void FileEntry::reuseUri(const std::vector<std::string>& ignore)
       A2_LOG_DEBUG(fmt("ignore host=%s", i.c_str()));
     }
   }
-  std::deque<std::string> uris = spentUris_;
+  std::vector<std::string> uris = spentUris_;
   std::sort(uris.begin(), uris.end());
   uris.erase(std::unique(uris.begin(), uris.end()), uris.end());
 
@@ -467,6 +467,14 @@ void FileEntry::releaseRuntimeResource()
   inFlightRequests_.clear();
 }
 
+void FileEntry::compact()
+{
+  releaseRuntimeResource();
+  std::vector<URIResult>().swap(uriResults_);
+  spentUris_.shrink_to_fit();
+  uris_.shrink_to_fit();
+}
+
 namespace {
 template <typename InputIterator>
 void putBackUri(std::deque<std::string>& uris, InputIterator first,
@@ -502,11 +510,11 @@ bool FileEntry::removeUri(const std::string& uri)
 {
   auto itr = std::find(spentUris_.begin(), spentUris_.end(), uri);
   if (itr == spentUris_.end()) {
-    itr = std::find(uris_.begin(), uris_.end(), uri);
-    if (itr == uris_.end()) {
+    auto i = std::find(uris_.begin(), uris_.end(), uri);
+    if (i == uris_.end()) {
       return false;
     }
-    uris_.erase(itr);
+    uris_.erase(i);
     return true;
   }
   spentUris_.erase(itr);
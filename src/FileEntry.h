@@ -75,10 +75,13 @@ private:
   int64_t offset_;
 
   std::deque<std::string> uris_;
-  std::deque<std::string> spentUris_;
+  // spentUris_ and uriResults_ are std::vector rather than std::deque,
+  // because an empty std::deque still allocates memory, and FileEntry
+  // objects are kept in DownloadResult after download stopped.
+  std::vector<std::string> spentUris_;
   // URIResult is stored in the ascending order of the time when its result is
   // available.
-  std::deque<URIResult> uriResults_;
+  std::vector<URIResult> uriResults_;
   RequestPool requestPool_;
   InFlightRequestSet inFlightRequests_;
 
@@ -137,10 +140,10 @@ public:
 
   std::deque<std::string>& getRemainingUris() { return uris_; }
 
-  const std::deque<std::string>& getSpentUris() const { return spentUris_; }
+  const std::vector<std::string>& getSpentUris() const { return spentUris_; }
 
   // Exposed for unittest
-  std::deque<std::string>& getSpentUris() { return spentUris_; }
+  std::vector<std::string>& getSpentUris() { return spentUris_; }
 
   size_t setUris(const std::vector<std::string>& uris);
 
@@ -222,7 +225,7 @@ public:
 
   void addURIResult(std::string uri, error_code::Value result);
 
-  const std::deque<URIResult>& getURIResults() const { return uriResults_; }
+  const std::vector<URIResult>& getURIResults() const { return uriResults_; }
 
   // Extracts URIResult whose _result is r and stores them into res.
   // The extracted URIResults are removed from uriResults_.
@@ -239,6 +242,11 @@ public:
 
   void releaseRuntimeResource();
 
+  // Frees memory which is only needed while download is in progress.
+  // This function is called when the download stopped and FileEntry
+  // is only kept in DownloadResult.
+  void compact();
+
   // Push URIs in pooled or in-flight requests to the front of uris_.
   void putBackRequest();
 
@@ -33,6 +33,9 @@
  */
 /* copyright --> */
 #include "HandshakeExtensionMessage.h"
+
+#include <algorithm>
+
 #include "Peer.h"
 #include "util.h"
 #include "DlAbortEx.h"
@@ -46,13 +49,14 @@
 #include "RequestGroup.h"
 #include "PieceStorage.h"
 #include "FileEntry.h"
+#include "BtConstants.h"
 
 namespace aria2 {
 
 const char HandshakeExtensionMessage::EXTENSION_NAME[] = "handshake";
 
 HandshakeExtensionMessage::HandshakeExtensionMessage()
-    : tcpPort_{0}, metadataSize_{0}, dctx_{nullptr}
+    : tcpPort_{0}, metadataSize_{0}, maxRequestQueue_{0}, dctx_{nullptr}
 {
 }
 
@@ -100,6 +104,9 @@ void HandshakeExtensionMessage::doReceivedAction()
     peer_->setPort(tcpPort_);
     peer_->setIncomingPeer(false);
   }
+  if (maxRequestQueue_ > 0) {
+    peer_->setMaxRequestQueue(maxRequestQueue_);
+  }
   for (int i = 0; i < ExtensionMessageRegistry::MAX_EXTENSION; ++i) {
     int id = extreg_.getExtensionMessageID(i);
     if (id) {
@@ -180,6 +187,11 @@ HandshakeExtensionMessage::create(const unsigned char* data, size_t length)
   if (port && 0 < port->i() && port->i() < 65536) {
     msg->tcpPort_ = port->i();
   }
+  const Integer* reqq = downcast<Integer>(dict->get("reqq"));
+  if (reqq && reqq->i() > 0) {
+    msg->maxRequestQueue_ =
+        std::min(reqq->i(), static_cast<int64_t>(UB_MAX_OUTSTANDING_REQUEST));
+  }
   const String* version = downcast<String>(dict->get("v"));
   if (version) {
     msg->clientVersion_ = version->s();
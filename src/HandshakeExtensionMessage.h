@@ -55,6 +55,10 @@ private:
 
   size_t metadataSize_;
 
+  // The value of "reqq": the number of outstanding requests the
+  // sender accepts.
+  size_t maxRequestQueue_;
+
   ExtensionMessageRegistry extreg_;
 
   DownloadContext* dctx_;
@@ -94,6 +98,10 @@ public:
 
   void setMetadataSize(size_t size) { metadataSize_ = size; }
 
+  size_t getMaxRequestQueue() const { return maxRequestQueue_; }
+
+  void setMaxRequestQueue(size_t n) { maxRequestQueue_ = n; }
+
   void setDownloadContext(DownloadContext* dctx) { dctx_ = dctx; }
 
   void setExtension(int key, uint8_t id);
@@ -44,7 +44,7 @@ void ARC4Encryptor::init(const unsigned char* key, size_t keyLength)
     c = j++;
 
   j = 0;
-  for (i = 0; i < sizeof(state_); ++i) {
+  for (i = 0; i < 256; ++i) {
     j = (j + state_[i] + key[i % keyLength]) & 0xff;
     auto tmp = state_[i];
     state_[i] = state_[j];
@@ -56,14 +56,22 @@ void ARC4Encryptor::init(const unsigned char* key, size_t keyLength)
 void ARC4Encryptor::encrypt(size_t len, unsigned char* out,
                             const unsigned char* in)
 {
-  for (auto c = 0u; c < len; ++c) {
-    i = (i + 1) & 0xff;
-    j = (j + state_[i]) & 0xff;
-    auto sj = state_[i];
-    auto si = state_[i] = state_[j];
-    state_[j] = sj;
-    out[c] = in[c] ^ state_[(si + sj) & 0xff];
+  // Work on local copies of the indexes so that they stay in
+  // registers throughout the loop.
+  auto s = state_;
+  auto x = i;
+  auto y = j;
+  for (size_t c = 0; c < len; ++c) {
+    x = (x + 1) & 0xff;
+    auto sx = s[x];
+    y = (y + sx) & 0xff;
+    auto sy = s[y];
+    s[x] = sy;
+    s[y] = sx;
+    out[c] = in[c] ^ s[(sx + sy) & 0xff];
   }
+  i = x;
+  j = y;
 }
 
 } // namespace aria2
@@ -92,6 +92,33 @@ typedef std::unique_ptr<STACK_OF(X509), x509_sk_deleter> x509_sk_t;
 
 namespace aria2 {
 
+#if OPENSSL_101_API
+namespace {
+// Called when a new session becomes available.  With TLSv1.3, this
+// happens after the handshake, when session tickets arrive.
+int newSessionCallback(SSL* ssl, SSL_SESSION* session)
+{
+  auto key = static_cast<const std::string*>(SSL_get_app_data(ssl));
+  if (!key || key->empty()) {
+    return 0;
+  }
+  auto tlsContext = static_cast<OpenSSLTLSContext*>(
+      SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+  tlsContext->addSession(*key, session);
+  // We took the ownership of session.
+  return 1;
+}
+} // namespace
+
+namespace {
+bool expired(SSL_SESSION* session, time_t now)
+{
+  return SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session) <=
+         now;
+}
+} // namespace
+#endif // OPENSSL_101_API
+
 TLSContext* TLSContext::make(TLSSessionSide side, TLSVersion minVer)
 {
   return new OpenSSLTLSContext(side, minVer);
@@ -151,6 +178,17 @@ OpenSSLTLSContext::OpenSSLTLSContext(TLSSessionSide side, TLSVersion minVer)
                      ERR_error_string(ERR_get_error(), nullptr)));
   }
 
+#if OPENSSL_101_API
+  if (side_ == TLS_CLIENT) {
+    // Sessions are stored per "host:port" by ourselves.
+    SSL_CTX_set_app_data(sslCtx_, this);
+    SSL_CTX_set_session_cache_mode(sslCtx_,
+                                   SSL_SESS_CACHE_CLIENT |
+                                       SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(sslCtx_, newSessionCallback);
+  }
+#endif // OPENSSL_101_API
+
 #if OPENSSL_VERSION_NUMBER < 0x30000000L &&                                    \
     OPENSSL_VERSION_NUMBER >= 0x0090800fL
 #  ifndef OPENSSL_NO_ECDH
@@ -168,10 +206,89 @@ OpenSSLTLSContext::OpenSSLTLSContext(TLSSessionSide side, TLSVersion minVer)
          // 0x0090800fL
 }
 
-OpenSSLTLSContext::~OpenSSLTLSContext() { SSL_CTX_free(sslCtx_); }
+OpenSSLTLSContext::~OpenSSLTLSContext()
+{
+#if OPENSSL_101_API
+  for (auto& e : sessionCache_) {
+    SSL_SESSION_free(e.second);
+  }
+#endif // OPENSSL_101_API
+  SSL_CTX_free(sslCtx_);
+}
+
+#if OPENSSL_101_API
+void OpenSSLTLSContext::addSession(const std::string& key,
+                                   SSL_SESSION* session)
+{
+  auto i = sessionCache_.find(key);
+  if (i != sessionCache_.end()) {
+    SSL_SESSION_free((*i).second);
+    (*i).second = session;
+    return;
+  }
+  if (sessionCache_.size() >= MAX_SESSION_CACHE_SIZE) {
+    // Drop expired sessions first.  If there is none, drop the
+    // oldest one.
+    auto now = time(nullptr);
+    auto oldest = sessionCache_.end();
+    for (auto j = sessionCache_.begin(); j != sessionCache_.end();) {
+      if (expired((*j).second, now)) {
+        SSL_SESSION_free((*j).second);
+        j = sessionCache_.erase(j);
+        continue;
+      }
+      if (oldest == sessionCache_.end() ||
+          SSL_SESSION_get_time((*j).second) <
+              SSL_SESSION_get_time((*oldest).second)) {
+        oldest = j;
+      }
+      ++j;
+    }
+    if (sessionCache_.size() >= MAX_SESSION_CACHE_SIZE) {
+      SSL_SESSION_free((*oldest).second);
+      sessionCache_.erase(oldest);
+    }
+  }
+  sessionCache_.emplace(key, session);
+}
+
+SSL_SESSION* OpenSSLTLSContext::getSession(const std::string& key)
+{
+  auto i = sessionCache_.find(key);
+  if (i == sessionCache_.end()) {
+    return nullptr;
+  }
+  auto session = (*i).second;
+  if (expired(session, time(nullptr))) {
+    SSL_SESSION_free(session);
+    sessionCache_.erase(i);
+    return nullptr;
+  }
+#  ifdef TLS1_3_VERSION
+  if (SSL_SESSION_get_protocol_version(session) == TLS1_3_VERSION) {
+    sessionCache_.erase(i);
+    return session;
+  }
+#  endif // TLS1_3_VERSION
+  SSL_SESSION_up_ref(session);
+  return session;
+}
+#endif // OPENSSL_101_API
 
 bool OpenSSLTLSContext::good() const { return good_; }
 
+bool OpenSSLTLSContext::enableKTLS()
+{
+#ifdef SSL_OP_ENABLE_KTLS
+  // OpenSSL falls back to user space if the kernel or the negotiated
+  // cipher does not support it.
+  SSL_CTX_set_options(sslCtx_, SSL_OP_ENABLE_KTLS);
+  return true;
+#else  // !SSL_OP_ENABLE_KTLS
+  return false;
+#endif // !SSL_OP_ENABLE_KTLS
+}
+
 bool OpenSSLTLSContext::addCredentialFile(const std::string& certfile,
                                           const std::string& keyfile)
 {
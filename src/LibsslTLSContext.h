@@ -38,11 +38,13 @@
 #include "common.h"
 
 #include <string>
+#include <map>
 
 #include <openssl/ssl.h>
 
 #include "TLSContext.h"
 #include "DlAbortEx.h"
+#include "libssl_compat.h"
 
 namespace aria2 {
 
@@ -72,13 +74,38 @@ public:
     verifyPeer_ = verify;
   }
 
+  virtual bool enableKTLS() CXX11_OVERRIDE;
+
   SSL_CTX* getSSLCtx() const { return sslCtx_; }
 
+#if OPENSSL_101_API
+  // Stores |session| established with the server identified by |key|,
+  // which is "host:port", so that later connections to the same
+  // server can resume it.  This object takes the ownership of
+  // |session|.  Only used for client side context.
+  void addSession(const std::string& key, SSL_SESSION* session);
+
+  // Returns the session cached for |key|, or nullptr if there is no
+  // usable one.  The caller must free the returned session.  TLSv1.3
+  // sessions are removed from the cache because their tickets should
+  // be used only once.
+  SSL_SESSION* getSession(const std::string& key);
+
+  size_t getSessionCacheSize() const { return sessionCache_.size(); }
+
+  // The maximum number of cached sessions.
+  static const size_t MAX_SESSION_CACHE_SIZE = 256;
+#endif // OPENSSL_101_API
+
 private:
   SSL_CTX* sslCtx_;
   TLSSessionSide side_;
   bool good_;
   bool verifyPeer_;
+#if OPENSSL_101_API
+  // Client side session cache, keyed by "host:port".
+  std::map<std::string, SSL_SESSION*> sessionCache_;
+#endif // OPENSSL_101_API
 };
 
 } // namespace aria2
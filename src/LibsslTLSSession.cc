@@ -39,6 +39,7 @@
 #include <openssl/x509v3.h>
 
 #include "LogFactory.h"
+#include "fmt.h"
 #include "util.h"
 #include "SocketCore.h"
 
@@ -218,6 +219,14 @@ int OpenSSLTLSSession::handshake(TLSVersion& version)
     break;
   }
 
+#ifdef SSL_OP_ENABLE_KTLS
+  if (SSL_get_options(ssl_) & SSL_OP_ENABLE_KTLS) {
+    A2_LOG_DEBUG(fmt("Kernel TLS send=%s, recv=%s",
+                     BIO_get_ktls_send(SSL_get_wbio(ssl_)) ? "on" : "off",
+                     BIO_get_ktls_recv(SSL_get_rbio(ssl_)) ? "on" : "off"));
+  }
+#endif // SSL_OP_ENABLE_KTLS
+
   return TLS_ERR_OK;
 }
 
@@ -226,11 +235,35 @@ int OpenSSLTLSSession::tlsConnect(const std::string& hostname,
                                   std::string& handshakeErr)
 {
   handshakeErr = "";
+#if OPENSSL_101_API
+  if (sessionKey_.empty() && !hostname.empty()) {
+    // First call for this connection.  Offer the cached session, if
+    // any, and let newSessionCallback know where the new one goes.
+    // The same host may run unrelated TLS servers on different ports,
+    // so the port of the peer is a part of the key.
+    sessionKey_ = hostname;
+    sockaddr_union su;
+    socklen_t len = sizeof(su);
+    if (getpeername(SSL_get_fd(ssl_), &su.sa, &len) == 0) {
+      sessionKey_ += ":";
+      sessionKey_ += util::uitos(util::getNumericNameInfo(&su.sa, len).port);
+    }
+    SSL_set_app_data(ssl_, &sessionKey_);
+    auto session = tlsContext_->getSession(sessionKey_);
+    if (session) {
+      SSL_set_session(ssl_, session);
+      SSL_SESSION_free(session);
+    }
+  }
+#endif // OPENSSL_101_API
   int ret;
   ret = handshake(version);
   if (ret != TLS_ERR_OK) {
     return ret;
   }
+  if (SSL_session_reused(ssl_)) {
+    A2_LOG_INFO(fmt("TLS session with %s was resumed.", hostname.c_str()));
+  }
   if (tlsContext_->getSide() == TLS_CLIENT && tlsContext_->getVerifyPeer()) {
     // verify peer
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
@@ -68,6 +68,9 @@ private:
   OpenSSLTLSContext* tlsContext_;
   // Last error code from openSSL library functions
   int rv_;
+  // "host:port" of the peer, where host is the hostname given in
+  // tlsConnect().  Used as the key of session cache.
+  std::string sessionKey_;
 };
 
 } // namespace aria2
@@ -192,6 +192,7 @@ void writeStackTrace(Output& fp, const char* stackTrace)
 void Logger::writeLog(Logger::LEVEL level, const char* sourceFile, int lineNum,
                       const char* msg, const char* trace)
 {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (fileLogEnabled(level)) {
     writeHeader(*fpp_, level, sourceFile, lineNum);
     fpp_->printf("%s\n", msg);
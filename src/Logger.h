@@ -39,6 +39,7 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 
 namespace aria2 {
 
@@ -64,6 +65,8 @@ private:
   // true if console log output is enabled.
   bool consoleOutput_;
   bool colorOutput_;
+  // Logger is also used from file allocation threads.
+  std::mutex mutex_;
   // Don't allow copying
   Logger(const Logger&);
   Logger& operator=(const Logger&);
@@ -277,8 +277,8 @@ void Metalink2RequestGroup::createRequestGroup(
       }
       if (entry->chunkChecksum) {
         dctx->setPieceHashes(entry->chunkChecksum->getHashType(),
-                             std::begin(entry->chunkChecksum->getPieceHashes()),
-                             std::end(entry->chunkChecksum->getPieceHashes()));
+                             entry->chunkChecksum->getPieceHashData(),
+                             entry->chunkChecksum->getPieceHashLength());
       }
       dctx->setSignature(entry->popSignature());
       rg->setNumConcurrentCommand(
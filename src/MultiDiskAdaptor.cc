@@ -43,6 +43,7 @@
 #include "util.h"
 #include "FileEntry.h"
 #include "MultiFileAllocationIterator.h"
+#include "ParallelFileAllocationIterator.h"
 #include "DefaultDiskWriterFactory.h"
 #include "DlAbortEx.h"
 #include "File.h"
@@ -114,7 +115,10 @@ bool DiskWriterEntry::operator<(const DiskWriterEntry& entry) const
   return *fileEntry_ < *entry.fileEntry_;
 }
 
-MultiDiskAdaptor::MultiDiskAdaptor() : pieceLength_{0}, readOnly_{false} {}
+MultiDiskAdaptor::MultiDiskAdaptor()
+    : pieceLength_{0}, readOnly_{false}, fileAllocationThreads_{0}
+{
+}
 
 MultiDiskAdaptor::~MultiDiskAdaptor() { closeFile(); }
 
@@ -449,6 +453,10 @@ int64_t MultiDiskAdaptor::size()
 std::unique_ptr<FileAllocationIterator>
 MultiDiskAdaptor::fileAllocationIterator()
 {
+  if (fileAllocationThreads_ > 0) {
+    return make_unique<ParallelFileAllocationIterator>(this,
+                                                       fileAllocationThreads_);
+  }
   return make_unique<MultiFileAllocationIterator>(this);
 }
 
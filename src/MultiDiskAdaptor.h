@@ -103,6 +103,10 @@ private:
 
   bool readOnly_;
 
+  // The number of threads used to allocate files.  If 0, files are
+  // allocated in the calling thread one by one.
+  int fileAllocationThreads_;
+
   void resetDiskWriterEntries();
 
   void openIfNot(DiskWriterEntry* entry, void (DiskWriterEntry::*f)());
@@ -158,6 +162,10 @@ public:
 
   int32_t getPieceLength() const { return pieceLength_; }
 
+  void setFileAllocationThreads(int n) { fileAllocationThreads_ = n; }
+
+  int getFileAllocationThreads() const { return fileAllocationThreads_; }
+
   virtual void cutTrailingGarbage() CXX11_OVERRIDE;
 
   virtual size_t utime(const Time& actime, const Time& modtime) CXX11_OVERRIDE;
@@ -198,6 +198,9 @@ int MultiUrlRequestInfo::prepare()
         throw DL_ABORT_EX("Loading private key and/or certificate for secure "
                           "RPC failed.");
       }
+      if (option_->getAsBool(PREF_ENABLE_KTLS) && !svTlsContext->enableKTLS()) {
+        A2_LOG_INFO("Kernel TLS is not supported by this build.");
+      }
       SocketCore::setServerTLSContext(svTlsContext);
     }
 #endif // ENABLE_SSL
@@ -253,6 +256,9 @@ int MultiUrlRequestInfo::prepare()
     auto minTLSVer = util::toTLSVersion(option_->get(PREF_MIN_TLS_VERSION));
     std::shared_ptr<TLSContext> clTlsContext(
         TLSContext::make(TLS_CLIENT, minTLSVer));
+    if (option_->getAsBool(PREF_ENABLE_KTLS) && !clTlsContext->enableKTLS()) {
+      A2_LOG_INFO("Kernel TLS is not supported by this build.");
+    }
     if (!option_->blank(PREF_CERTIFICATE)) {
       clTlsContext->addCredentialFile(option_->get(PREF_CERTIFICATE),
                                       option_->get(PREF_PRIVATE_KEY));
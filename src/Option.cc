@@ -36,15 +36,13 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 
 #include "bitfield.h"
 
 namespace aria2 {
 
-Option::Option()
-    : table_(option::countOption()), use_((option::countOption() + 7) / 8)
-{
-}
+Option::Option() : use_((option::countOption() + 7) / 8) {}
 
 Option::~Option() = default;
 
@@ -72,12 +70,44 @@ template <typename V> void unsetBit(V& b, PrefPtr pref)
   b[pref->i / 8] &= ~(128 >> (pref->i % 8));
 }
 
+template <typename InputIterator>
+InputIterator lowerBound(InputIterator first, InputIterator last, size_t i)
+{
+  return std::lower_bound(
+      first, last, i,
+      [](const std::pair<size_t, std::string>& ent, size_t i) {
+        return ent.first < i;
+      });
+}
+
 } // namespace
 
+std::string* Option::findLocal(PrefPtr pref)
+{
+  if (!bitfield::test(use_, use_.size() * 8, pref->i)) {
+    return nullptr;
+  }
+  return &(*lowerBound(std::begin(table_), std::end(table_), pref->i)).second;
+}
+
+const std::string* Option::findLocal(PrefPtr pref) const
+{
+  if (!bitfield::test(use_, use_.size() * 8, pref->i)) {
+    return nullptr;
+  }
+  return &(*lowerBound(std::begin(table_), std::end(table_), pref->i)).second;
+}
+
 void Option::put(PrefPtr pref, const std::string& value)
 {
+  auto v = findLocal(pref);
+  if (v) {
+    *v = value;
+    return;
+  }
   setBit(use_, pref);
-  table_[pref->i] = value;
+  table_.emplace(lowerBound(std::begin(table_), std::end(table_), pref->i),
+                 pref->i, value);
 }
 
 bool Option::defined(PrefPtr pref) const
@@ -93,8 +123,9 @@ bool Option::definedLocal(PrefPtr pref) const
 
 bool Option::blank(PrefPtr pref) const
 {
-  if (bitfield::test(use_, use_.size() * 8, pref->i)) {
-    return table_[pref->i].empty();
+  auto v = findLocal(pref);
+  if (v) {
+    return v->empty();
   }
   else {
     return !parent_ || parent_->blank(pref);
@@ -103,8 +134,9 @@ bool Option::blank(PrefPtr pref) const
 
 const std::string& Option::get(PrefPtr pref) const
 {
-  if (bitfield::test(use_, use_.size() * 8, pref->i)) {
-    return table_[pref->i];
+  auto v = findLocal(pref);
+  if (v) {
+    return *v;
   }
   else if (parent_) {
     return parent_->get(pref);
@@ -151,8 +183,11 @@ double Option::getAsDouble(PrefPtr pref) const
 
 void Option::removeLocal(PrefPtr pref)
 {
+  if (!bitfield::test(use_, use_.size() * 8, pref->i)) {
+    return;
+  }
   unsetBit(use_, pref);
-  table_[pref->i].clear();
+  table_.erase(lowerBound(std::begin(table_), std::end(table_), pref->i));
 }
 
 void Option::remove(PrefPtr pref)
@@ -166,17 +201,13 @@ void Option::remove(PrefPtr pref)
 void Option::clear()
 {
   std::fill(use_.begin(), use_.end(), 0);
-  std::fill(table_.begin(), table_.end(), "");
+  table_.clear();
 }
 
 void Option::merge(const Option& option)
 {
-  size_t bits = option.use_.size() * 8;
-  for (size_t i = 1, len = table_.size(); i < len; ++i) {
-    if (bitfield::test(option.use_, bits, i)) {
-      use_[i / 8] |= 128 >> (i % 8);
-      table_[i] = option.table_[i];
-    }
+  for (auto& ent : option.table_) {
+    put(option::i2p(ent.first), ent.second);
   }
 }
 
@@ -187,10 +218,6 @@ void Option::setParent(const std::shared_ptr<Option>& parent)
 
 const std::shared_ptr<Option>& Option::getParent() const { return parent_; }
 
-bool Option::emptyLocal() const
-{
-  size_t dst;
-  return !bitfield::getFirstSetBitIndex(dst, use_, use_.size() * 8);
-}
+bool Option::emptyLocal() const { return table_.empty(); }
 
 } // namespace aria2
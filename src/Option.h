@@ -40,6 +40,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <utility>
 
 #include "prefs.h"
 
@@ -47,10 +48,18 @@ namespace aria2 {
 
 class Option {
 private:
-  std::vector<std::string> table_;
+  // Option values defined in this object, sorted by pref->i.  Most
+  // Option objects (e.g., per-download options) only override a
+  // handful of options, so we don't allocate a slot for every option.
+  std::vector<std::pair<size_t, std::string>> table_;
+  // Bitmap of the options defined in this object.  This makes
+  // defined() and lookup misses, which fall through to parent_, O(1).
   std::vector<unsigned char> use_;
   std::shared_ptr<Option> parent_;
 
+  std::string* findLocal(PrefPtr pref);
+  const std::string* findLocal(PrefPtr pref) const;
+
 public:
   Option();
   ~Option();
@@ -83,9 +92,9 @@ public:
   // Removes all option values from this object. This function does
   // not modify parent_.
   void clear();
-  // Returns the option value table of this object. It does not
-  // contain option values in parent_ and so forth.
-  const std::vector<std::string>& getTable() const { return table_; }
+  // Returns the number of option values defined in this object. It
+  // does not count option values in parent_ and so forth.
+  size_t countLocal() const { return table_.size(); }
   // Copy option values defined in option to this option. parent_ is
   // left unmodified for this object.
   void merge(const Option& option);
@@ -0,0 +1,220 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2006 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "ParallelFileAllocationIterator.h"
+
+#include <algorithm>
+#include <system_error>
+
+#include "MultiDiskAdaptor.h"
+#include "FileEntry.h"
+#include "AdaptiveFileAllocationIterator.h"
+#include "TruncFileAllocationIterator.h"
+#ifdef HAVE_SOME_FALLOCATE
+#  include "FallocFileAllocationIterator.h"
+#endif // HAVE_SOME_FALLOCATE
+#include "DiskWriter.h"
+#include "DefaultDiskWriterFactory.h"
+#include "DlAbortEx.h"
+#include "File.h"
+#include "LogFactory.h"
+#include "fmt.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+ParallelFileAllocationIterator::ParallelFileAllocationIterator(
+    MultiDiskAdaptor* diskAdaptor, int numThreads)
+    : fileAllocationMethod_{diskAdaptor->getFileAllocationMethod()},
+      numThreads_{std::max(1, numThreads)},
+      totalLength_{0},
+      currentLength_{0},
+      next_{0},
+      numRunning_{0},
+      halt_{false},
+      started_{false}
+{
+  // Copy what the workers need, so that they never touch
+  // DiskWriterEntry which is owned by the event loop thread.
+  for (auto& dwent : diskAdaptor->getDiskWriterEntries()) {
+    if (!dwent->getDiskWriter()) {
+      continue;
+    }
+    auto length = dwent->getFileEntry()->getLength();
+    entries_.push_back(
+        Entry{dwent->getFilePath(), length, dwent->needsFileAllocation()});
+    if (dwent->needsFileAllocation()) {
+      totalLength_ += length;
+    }
+  }
+}
+
+ParallelFileAllocationIterator::~ParallelFileAllocationIterator()
+{
+  halt_ = true;
+  joinThreads();
+}
+
+void ParallelFileAllocationIterator::joinThreads()
+{
+  for (auto& th : threads_) {
+    th.join();
+  }
+  threads_.clear();
+}
+
+void ParallelFileAllocationIterator::allocateChunk()
+{
+  if (!started_) {
+    started_ = true;
+    auto n = std::min(static_cast<size_t>(numThreads_), entries_.size());
+    for (size_t i = 0; i < n; ++i) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++numRunning_;
+      }
+      try {
+        threads_.emplace_back(&ParallelFileAllocationIterator::run, this);
+      }
+      catch (std::system_error& e) {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          --numRunning_;
+        }
+        if (!threads_.empty()) {
+          break;
+        }
+        throw DL_ABORT_EX(
+            fmt("Could not start file allocation thread: %s", e.what()));
+      }
+    }
+  }
+
+  std::exception_ptr error;
+  bool done;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done = numRunning_ == 0;
+    error = error_;
+  }
+  if (done) {
+    joinThreads();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ParallelFileAllocationIterator::run()
+{
+  for (;;) {
+    size_t i;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (halt_ || next_ == entries_.size()) {
+        break;
+      }
+      i = next_++;
+    }
+    try {
+      allocateFile(entries_[i]);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      halt_ = true;
+      break;
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  --numRunning_;
+}
+
+void ParallelFileAllocationIterator::allocateFile(const Entry& entry)
+{
+  // Like MultiFileAllocationIterator, use dedicated DiskWriter so
+  // that OpenedFileCounter never closes the file under us.
+  auto diskWriter = DefaultDiskWriterFactory().newDiskWriter(entry.path);
+  diskWriter->openFile(entry.length);
+  auto size = File(entry.path).size();
+  if (entry.needsFileAllocation && size < entry.length) {
+    A2_LOG_INFO(fmt("Allocating file %s: target size=%" PRId64
+                    ", current size=%" PRId64,
+                    entry.path.c_str(), entry.length, size));
+    std::unique_ptr<FileAllocationIterator> itr;
+    switch (fileAllocationMethod_) {
+#ifdef HAVE_SOME_FALLOCATE
+    case (DiskAdaptor::FILE_ALLOC_FALLOC):
+      itr = make_unique<FallocFileAllocationIterator>(diskWriter.get(), size,
+                                                      entry.length);
+      break;
+#endif // HAVE_SOME_FALLOCATE
+    case (DiskAdaptor::FILE_ALLOC_TRUNC):
+      itr = make_unique<TruncFileAllocationIterator>(diskWriter.get(), size,
+                                                     entry.length);
+      break;
+    default:
+      itr = make_unique<AdaptiveFileAllocationIterator>(diskWriter.get(), size,
+                                                        entry.length);
+      break;
+    }
+    while (!itr->finished() && !halt_) {
+      itr->allocateChunk();
+    }
+  }
+  diskWriter->closeFile();
+  if (entry.needsFileAllocation) {
+    currentLength_ += entry.length;
+  }
+}
+
+bool ParallelFileAllocationIterator::finished()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return next_ == entries_.size() && numRunning_ == 0 && !error_;
+}
+
+int64_t ParallelFileAllocationIterator::getCurrentLength()
+{
+  return currentLength_;
+}
+
+int64_t ParallelFileAllocationIterator::getTotalLength()
+{
+  return totalLength_;
+}
+
+} // namespace aria2
@@ -0,0 +1,108 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2006 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_PARALLEL_FILE_ALLOCATION_ITERATOR_H
+#define D_PARALLEL_FILE_ALLOCATION_ITERATOR_H
+
+#include "FileAllocationIterator.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <atomic>
+
+namespace aria2 {
+
+class MultiDiskAdaptor;
+
+// Allocates the files of MultiDiskAdaptor in worker threads, so that
+// several files are allocated at once and the event loop is not
+// blocked by the allocation of a large file.  The worker threads
+// only touch the files through their own DiskWriter, and errors are
+// rethrown from allocateChunk() in the calling thread.
+class ParallelFileAllocationIterator : public FileAllocationIterator {
+private:
+  struct Entry {
+    std::string path;
+    int64_t length;
+    bool needsFileAllocation;
+  };
+
+  std::vector<Entry> entries_;
+  int fileAllocationMethod_;
+  int numThreads_;
+  int64_t totalLength_;
+  std::atomic<int64_t> currentLength_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  // Index of the next entry to be allocated.  Guarded by mutex_.
+  size_t next_;
+  // The number of workers still running.  Guarded by mutex_.
+  int numRunning_;
+  // The first error raised by a worker.  Guarded by mutex_.
+  std::exception_ptr error_;
+  std::atomic<bool> halt_;
+  bool started_;
+
+  void run();
+
+  void allocateFile(const Entry& entry);
+
+  void joinThreads();
+
+public:
+  ParallelFileAllocationIterator(MultiDiskAdaptor* diskAdaptor,
+                                 int numThreads);
+
+  virtual ~ParallelFileAllocationIterator();
+
+  // Starts the worker threads on the first call.  Subsequent calls
+  // do not block: they join the workers if all of them have finished
+  // and rethrow the error raised by a worker, if any.
+  virtual void allocateChunk() CXX11_OVERRIDE;
+
+  virtual bool finished() CXX11_OVERRIDE;
+
+  virtual int64_t getCurrentLength() CXX11_OVERRIDE;
+
+  virtual int64_t getTotalLength() CXX11_OVERRIDE;
+
+  virtual bool allocatesInBackground() CXX11_OVERRIDE { return true; }
+};
+
+} // namespace aria2
+
+#endif // D_PARALLEL_FILE_ALLOCATION_ITERATOR_H
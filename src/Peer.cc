@@ -359,6 +359,18 @@ bool Peer::isDHTEnabled() const
   return res_->dhtEnabled();
 }
 
+void Peer::setMaxRequestQueue(size_t n)
+{
+  assert(res_);
+  res_->maxRequestQueue(n);
+}
+
+size_t Peer::getMaxRequestQueue() const
+{
+  assert(res_);
+  return res_->maxRequestQueue();
+}
+
 const Timer& Peer::getLastDownloadUpdate() const
 {
   assert(res_);
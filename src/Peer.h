@@ -235,6 +235,12 @@ public:
 
   bool isDHTEnabled() const;
 
+  // Sets the number of outstanding requests this peer accepts.  0
+  // means that the peer did not advertise it.
+  void setMaxRequestQueue(size_t n);
+
+  size_t getMaxRequestQueue() const;
+
   bool shouldBeChoking() const;
 
   bool hasPiece(size_t index) const;
@@ -229,6 +229,9 @@ PeerInteractionCommand::PeerInteractionCommand(
   btInteractive->setRequestGroupMan(
       getDownloadEngine()->getRequestGroupMan().get());
   btInteractive->setBtMessageFactory(std::move(factory));
+  if (getOption()->getAsBool(PREF_BT_SUPER_SEEDING)) {
+    btInteractive->setSuperSeeding(true);
+  }
   if ((metadataGetMode || !torrentAttrs->privateTorrent) &&
       !getPeer()->isLocalPeer()) {
     if (getOption()->getAsBool(PREF_ENABLE_PEER_EXCHANGE)) {
@@ -84,6 +84,9 @@ private:
   bool fastExtensionEnabled_;
   bool extendedMessagingEnabled_;
   bool dhtEnabled_;
+  // The number of outstanding requests this peer accepts, advertised
+  // with "reqq" in the extended handshake.  0 means not advertised.
+  size_t maxRequestQueue_;
 
 public:
   PeerSessionResource(int32_t pieceLength, int64_t totalLength);
@@ -178,6 +181,10 @@ public:
 
   void dhtEnabled(bool b);
 
+  size_t maxRequestQueue() const { return maxRequestQueue_; }
+
+  void maxRequestQueue(size_t n) { maxRequestQueue_ = n; }
+
   NetStat& getNetStat() { return netStat_; }
 
   int64_t uploadLength() const;
@@ -124,6 +124,14 @@ public:
   virtual std::shared_ptr<Piece>
   getMissingPiece(const std::shared_ptr<Peer>& peer,
                   const std::vector<size_t>& excludedIndexes, cuid_t cuid) = 0;
+
+  // Chooses the piece to advertise next to the peer in super-seeding
+  // mode and stores its index in index.  The piece is the one the
+  // peer doesn't have which has been advertised the least, and then
+  // which is the rarest in the swarm.  Returns false if there is no
+  // such piece.
+  virtual bool getSuperSeedingPieceIndex(size_t& index,
+                                         const std::shared_ptr<Peer>& peer) = 0;
 #endif // ENABLE_BITTORRENT
 
   // Returns true if there is at least one missing and unused piece.
@@ -40,6 +40,7 @@
 #include <memory>
 
 #include "TimerA2.h"
+#include "Command.h"
 #include "uri.h"
 
 namespace aria2 {
@@ -150,7 +151,9 @@ public:
 
   const std::shared_ptr<PeerStat>& getPeerStat() const { return peerStat_; }
 
-  const std::shared_ptr<PeerStat>& initPeerStat();
+  // Creates new PeerStat for the command whose CUID is cuid and
+  // returns it.
+  const std::shared_ptr<PeerStat>& initPeerStat(cuid_t cuid);
 
   void requestRemoval() { removalRequested_ = true; }
 
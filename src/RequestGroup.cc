@@ -140,8 +140,8 @@ RequestGroup::RequestGroup(const std::shared_ptr<GroupId>& gid,
       numStreamCommand_(0),
       numCommand_(0),
       fileNotFoundCount_(0),
-      maxDownloadSpeedLimit_(option->getAsInt(PREF_MAX_DOWNLOAD_LIMIT)),
-      maxUploadSpeedLimit_(option->getAsInt(PREF_MAX_UPLOAD_LIMIT)),
+      downloadBucket_(option->getAsInt(PREF_MAX_DOWNLOAD_LIMIT)),
+      uploadBucket_(option->getAsInt(PREF_MAX_UPLOAD_LIMIT)),
       resumeFailureCount_(0),
       haltReason_(RequestGroup::NONE),
       lastErrorCode_(error_code::UNDEFINED),
@@ -981,7 +981,7 @@ void RequestGroup::decreaseNumCommand()
   --numCommand_;
   if (!numCommand_ && requestGroupMan_) {
     A2_LOG_DEBUG(fmt("GID#%s - Request queue check", gid_->toHex().c_str()));
-    requestGroupMan_->requestQueueCheck();
+    requestGroupMan_->addStoppedGroup(getGID());
   }
 }
 
@@ -1276,18 +1276,6 @@ void RequestGroup::setTimeout(std::chrono::seconds timeout)
   timeout_ = std::move(timeout);
 }
 
-bool RequestGroup::doesDownloadSpeedExceed()
-{
-  int spd = downloadContext_->getNetStat().calculateDownloadSpeed();
-  return maxDownloadSpeedLimit_ > 0 && maxDownloadSpeedLimit_ < spd;
-}
-
-bool RequestGroup::doesUploadSpeedExceed()
-{
-  int spd = downloadContext_->getNetStat().calculateUploadSpeed();
-  return maxUploadSpeedLimit_ > 0 && maxUploadSpeedLimit_ < spd;
-}
-
 void RequestGroup::saveControlFile() const
 {
   if (saveControlFile_) {
@@ -49,6 +49,7 @@
 #include "error_code.h"
 #include "MetadataInfo.h"
 #include "GroupId.h"
+#include "TokenBucket.h"
 
 namespace aria2 {
 
@@ -157,9 +158,11 @@ private:
 
   int fileNotFoundCount_;
 
-  int maxDownloadSpeedLimit_;
+  // Enforces the download/upload speed limit of this group.  The rate
+  // is 0 if there is no limit.
+  TokenBucket downloadBucket_;
 
-  int maxUploadSpeedLimit_;
+  TokenBucket uploadBucket_;
 
   int resumeFailureCount_;
 
@@ -426,23 +429,25 @@ public:
 
   const std::chrono::seconds& getTimeout() const { return timeout_; }
 
-  // Returns true if current download speed exceeds
-  // maxDownloadSpeedLimit_.  Always returns false if
-  // maxDownloadSpeedLimit_ == 0.  Otherwise returns false.
-  bool doesDownloadSpeedExceed();
+  // Returns true if this group has used up its download speed limit
+  // for now.  Always returns false if the limit is 0.
+  bool doesDownloadSpeedExceed() { return downloadBucket_.exhausted(); }
 
-  // Returns true if current upload speed exceeds
-  // maxUploadSpeedLimit_. Always returns false if
-  // maxUploadSpeedLimit_ == 0. Otherwise returns false.
-  bool doesUploadSpeedExceed();
+  // Returns true if this group has used up its upload speed limit for
+  // now.  Always returns false if the limit is 0.
+  bool doesUploadSpeedExceed() { return uploadBucket_.exhausted(); }
 
-  int getMaxDownloadSpeedLimit() const { return maxDownloadSpeedLimit_; }
+  int getMaxDownloadSpeedLimit() const { return downloadBucket_.getRate(); }
 
-  void setMaxDownloadSpeedLimit(int speed) { maxDownloadSpeedLimit_ = speed; }
+  void setMaxDownloadSpeedLimit(int speed) { downloadBucket_.setRate(speed); }
 
-  int getMaxUploadSpeedLimit() const { return maxUploadSpeedLimit_; }
+  int getMaxUploadSpeedLimit() const { return uploadBucket_.getRate(); }
 
-  void setMaxUploadSpeedLimit(int speed) { maxUploadSpeedLimit_ = speed; }
+  void setMaxUploadSpeedLimit(int speed) { uploadBucket_.setRate(speed); }
+
+  TokenBucket& getDownloadBucket() { return downloadBucket_; }
+
+  TokenBucket& getUploadBucket() { return uploadBucket_; }
 
   void setLastErrorCode(error_code::Value code, const char* message = "")
   {
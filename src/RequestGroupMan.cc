@@ -41,6 +41,7 @@
 #include <numeric>
 #include <algorithm>
 #include <utility>
+#include <set>
 
 #include "BtProgressInfoFile.h"
 #include "RecoverableException.h"
@@ -113,10 +114,8 @@ RequestGroupMan::RequestGroupMan(
       numActive_(0),
       option_(option),
       serverStatMan_(std::make_shared<ServerStatMan>()),
-      maxOverallDownloadSpeedLimit_(
-          option->getAsInt(PREF_MAX_OVERALL_DOWNLOAD_LIMIT)),
-      maxOverallUploadSpeedLimit_(
-          option->getAsInt(PREF_MAX_OVERALL_UPLOAD_LIMIT)),
+      downloadBucket_(option->getAsInt(PREF_MAX_OVERALL_DOWNLOAD_LIMIT)),
+      uploadBucket_(option->getAsInt(PREF_MAX_OVERALL_UPLOAD_LIMIT)),
       keepRunning_(option->getAsBool(PREF_ENABLE_RPC)),
       queueCheck_(true),
       removedErrorResult_(0),
@@ -163,6 +162,9 @@ void RequestGroupMan::addRequestGroup(
 {
   ++numActive_;
   requestGroups_.push_back(group->getGID(), group);
+  if (group->getNumCommand() == 0) {
+    addStoppedGroup(group->getGID());
+  }
 }
 
 void RequestGroupMan::addReservedGroup(
@@ -458,6 +460,11 @@ public:
         e_->getRequestGroupMan()->addDownloadResult(dr);
         executeStopHook(group, e_->getOption(), dr->result);
         group->releaseRuntimeResource(e_);
+        // The group is dropped here, and FileEntry objects are only
+        // kept in DownloadResult from now on.
+        for (auto& fileEntry : dr->fileEntries) {
+          fileEntry->compact();
+        }
       }
 
       group->setRestartRequested(false);
@@ -472,15 +479,42 @@ public:
 };
 } // namespace
 
+void RequestGroupMan::addStoppedGroup(a2_gid_t gid)
+{
+  stoppedGroups_.push_back(gid);
+  requestQueueCheck();
+}
+
 void RequestGroupMan::removeStoppedGroup(DownloadEngine* e)
 {
-  size_t numPrev = requestGroups_.size();
-  requestGroups_.remove_if(ProcessStoppedRequestGroup(e, reservedGroups_));
-  size_t numRemoved = numPrev - requestGroups_.size();
-  if (numRemoved > 0) {
-    A2_LOG_DEBUG(fmt("%lu RequestGroup(s) deleted.",
-                     static_cast<unsigned long>(numRemoved)));
+  if (stoppedGroups_.empty()) {
+    return;
   }
+  std::vector<a2_gid_t> gids;
+  gids.swap(stoppedGroups_);
+  std::set<a2_gid_t> removed;
+  ProcessStoppedRequestGroup proc(e, reservedGroups_);
+  for (auto gid : gids) {
+    // The same GID may be added more than once.  proc() skips the
+    // group if it has got new commands since it was added.
+    if (removed.count(gid)) {
+      continue;
+    }
+    auto group = requestGroups_.get(gid);
+    if (group && proc(group)) {
+      removed.insert(gid);
+    }
+  }
+  if (removed.empty()) {
+    return;
+  }
+  // IndexedList::remove() scans the list for each key, so remove all
+  // groups in one pass.
+  requestGroups_.remove_if([&removed](const std::shared_ptr<RequestGroup>& g) {
+    return removed.count(g->getGID());
+  });
+  A2_LOG_DEBUG(fmt("%lu RequestGroup(s) deleted.",
+                   static_cast<unsigned long>(removed.size())));
 }
 
 void RequestGroupMan::configureRequestGroup(
@@ -562,7 +596,7 @@ void RequestGroupMan::fillRequestGroupFromReserver(DownloadEngine* e)
       auto res = createInitialCommand(groupToAdd, e);
       ++count;
       if (res.empty()) {
-        requestQueueCheck();
+        addStoppedGroup(groupToAdd->getGID());
       }
       else {
         e->addCommand(std::move(res));
@@ -574,7 +608,7 @@ void RequestGroupMan::fillRequestGroupFromReserver(DownloadEngine* e)
       groupToAdd->setLastErrorCode(ex.getErrorCode(), ex.what());
       // We add groupToAdd to e later in order to it is processed in
       // removeStoppedGroup().
-      requestQueueCheck();
+      addStoppedGroup(groupToAdd->getGID());
     }
 
     util::executeHookByOptName(groupToAdd, e->getOption(),
@@ -983,18 +1017,6 @@ void RequestGroupMan::removeStaleServerStat(const std::chrono::seconds& timeout)
   serverStatMan_->removeStaleServerStat(timeout);
 }
 
-bool RequestGroupMan::doesOverallDownloadSpeedExceed()
-{
-  return maxOverallDownloadSpeedLimit_ > 0 &&
-         maxOverallDownloadSpeedLimit_ < netStat_.calculateDownloadSpeed();
-}
-
-bool RequestGroupMan::doesOverallUploadSpeedExceed()
-{
-  return maxOverallUploadSpeedLimit_ > 0 &&
-         maxOverallUploadSpeedLimit_ < netStat_.calculateUploadSpeed();
-}
-
 void RequestGroupMan::getUsedHosts(
     std::vector<std::pair<size_t, std::string>>& usedHosts)
 {
@@ -1090,9 +1112,10 @@ int RequestGroupMan::optimizeConcurrentDownloads()
   }
 
   // apply the rule
-  if ((maxOverallDownloadSpeedLimit_ > 0) &&
-      (optimizationSpeed_ > maxOverallDownloadSpeedLimit_)) {
-    optimizationSpeed_ = maxOverallDownloadSpeedLimit_;
+  const int maxOverallDownloadSpeedLimit = getMaxOverallDownloadSpeedLimit();
+  if ((maxOverallDownloadSpeedLimit > 0) &&
+      (optimizationSpeed_ > maxOverallDownloadSpeedLimit)) {
+    optimizationSpeed_ = maxOverallDownloadSpeedLimit;
   }
   int maxConcurrentDownloads =
       ceil(optimizeConcurrentDownloadsCoeffA_ +
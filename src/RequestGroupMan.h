@@ -48,6 +48,7 @@
 #include "RequestGroup.h"
 #include "NetStat.h"
 #include "IndexedList.h"
+#include "TokenBucket.h"
 
 namespace aria2 {
 
@@ -95,9 +96,11 @@ private:
 
   std::shared_ptr<ServerStatMan> serverStatMan_;
 
-  int maxOverallDownloadSpeedLimit_;
+  // Enforces the overall download/upload speed limit.  The rate is 0
+  // if there is no limit.
+  TokenBucket downloadBucket_;
 
-  int maxOverallUploadSpeedLimit_;
+  TokenBucket uploadBucket_;
 
   NetStat netStat_;
 
@@ -107,6 +110,11 @@ private:
 
   bool queueCheck_;
 
+  // GIDs of active RequestGroups whose number of commands dropped to
+  // 0.  removeStoppedGroup() looks up only these groups by GID
+  // instead of evaluating every group in requestGroups_.
+  std::vector<a2_gid_t> stoppedGroups_;
+
   // The number of error DownloadResult removed because of upper limit
   // of the queue
   int removedErrorResult_;
@@ -286,35 +294,31 @@ public:
 
   void removeStaleServerStat(const std::chrono::seconds& timeout);
 
-  // Returns true if current download speed exceeds
-  // maxOverallDownloadSpeedLimit_.  Always returns false if
-  // maxOverallDownloadSpeedLimit_ == 0.  Otherwise returns false.
-  bool doesOverallDownloadSpeedExceed();
+  // Returns true if the overall download speed limit is used up for
+  // now.  Always returns false if the limit is 0.
+  bool doesOverallDownloadSpeedExceed() { return downloadBucket_.exhausted(); }
 
   void setMaxOverallDownloadSpeedLimit(int speed)
   {
-    maxOverallDownloadSpeedLimit_ = speed;
+    downloadBucket_.setRate(speed);
   }
 
   int getMaxOverallDownloadSpeedLimit() const
   {
-    return maxOverallDownloadSpeedLimit_;
+    return downloadBucket_.getRate();
   }
 
-  // Returns true if current upload speed exceeds
-  // maxOverallUploadSpeedLimit_. Always returns false if
-  // maxOverallUploadSpeedLimit_ == 0. Otherwise returns false.
-  bool doesOverallUploadSpeedExceed();
+  // Returns true if the overall upload speed limit is used up for
+  // now.  Always returns false if the limit is 0.
+  bool doesOverallUploadSpeedExceed() { return uploadBucket_.exhausted(); }
 
-  void setMaxOverallUploadSpeedLimit(int speed)
-  {
-    maxOverallUploadSpeedLimit_ = speed;
-  }
+  void setMaxOverallUploadSpeedLimit(int speed) { uploadBucket_.setRate(speed); }
 
-  int getMaxOverallUploadSpeedLimit() const
-  {
-    return maxOverallUploadSpeedLimit_;
-  }
+  int getMaxOverallUploadSpeedLimit() const { return uploadBucket_.getRate(); }
+
+  TokenBucket& getDownloadBucket() { return downloadBucket_; }
+
+  TokenBucket& getUploadBucket() { return uploadBucket_; }
 
   void setMaxConcurrentDownloads(int max) { maxConcurrentDownloads_ = max; }
 
@@ -327,6 +331,11 @@ public:
 
   bool queueCheckRequested() const { return queueCheck_; }
 
+  // Tells this object that RequestGroup identified by |gid| has no
+  // running command, and may be removed by removeStoppedGroup().
+  // This function also requests queue check.
+  void addStoppedGroup(a2_gid_t gid);
+
   // Returns currently used hosts and its use count.
   void getUsedHosts(std::vector<std::pair<size_t, std::string>>& usedHosts);
 
@@ -1210,7 +1210,7 @@ std::unique_ptr<ValueBase>
 GetGlobalOptionRpcMethod::process(const RpcRequest& req, DownloadEngine* e)
 {
   auto result = Dict::g();
-  for (size_t i = 0, len = e->getOption()->getTable().size(); i < len; ++i) {
+  for (size_t i = 0, len = option::countOption(); i < len; ++i) {
     PrefPtr pref = option::i2p(i);
     if (pref == PREF_RPC_SECRET || !e->getOption()->defined(pref)) {
       continue;
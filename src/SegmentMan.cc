@@ -37,6 +37,7 @@
 #include <cassert>
 #include <algorithm>
 #include <numeric>
+#include <limits>
 
 #include "util.h"
 #include "message.h"
@@ -59,7 +60,7 @@
 namespace aria2 {
 
 SegmentEntry::SegmentEntry(cuid_t cuid, const std::shared_ptr<Segment>& segment)
-    : cuid(cuid), segment(segment)
+    : cuid(cuid), segment(segment), assignedTime(global::wallclock())
 {
 }
 
@@ -282,6 +283,83 @@ std::shared_ptr<Segment> SegmentMan::getCleanSegmentIfOwnerIsIdle(cuid_t cuid,
   return nullptr;
 }
 
+namespace {
+// The command steals a segment only if it is at least this times
+// faster than the current owner of the segment.
+constexpr int STEAL_SPEED_FACTOR = 2;
+// The estimated cost of discarding the current connection of the
+// owner and issuing a new request for the segment.
+constexpr int64_t STEAL_HANDICAP_MILLIS = 2000;
+// The owner which has not downloaded anything is not a victim until
+// it has held the segment for this long, because its speed is not
+// measured yet.
+constexpr auto STEAL_MIN_HOLD_TIME = 10_s;
+} // namespace
+
+namespace {
+int getDownloadSpeed(const std::shared_ptr<PeerStat>& ps)
+{
+  if (!ps) {
+    return 0;
+  }
+  int speed = ps->calculateDownloadSpeed();
+  if (speed == 0) {
+    speed = ps->getAvgDownloadSpeed();
+  }
+  return speed;
+}
+} // namespace
+
+std::shared_ptr<Segment> SegmentMan::stealSegment(cuid_t cuid)
+{
+  int speed = getDownloadSpeed(getPeerStat(cuid));
+  if (speed == 0) {
+    // We don't know how fast we are.
+    return nullptr;
+  }
+  std::shared_ptr<SegmentEntry> victim;
+  int64_t victimEta = 0;
+  for (auto& e : usedSegmentEntries_) {
+    if (e->cuid == cuid) {
+      continue;
+    }
+    const auto& segment = e->segment;
+    auto remaining = segment->getLength() - segment->getWrittenLength();
+    if (remaining <= 0) {
+      continue;
+    }
+    auto ownerSpeed = getDownloadSpeed(getPeerStat(e->cuid));
+    if (static_cast<int64_t>(ownerSpeed) * STEAL_SPEED_FACTOR > speed) {
+      continue;
+    }
+    if (ownerSpeed == 0 &&
+        e->assignedTime.difference(global::wallclock()) < STEAL_MIN_HOLD_TIME) {
+      continue;
+    }
+    auto eta = remaining * 1000 / speed + STEAL_HANDICAP_MILLIS;
+    // If owner has not made progress for STEAL_MIN_HOLD_TIME, treat
+    // its ETA as infinite.
+    auto ownerEta = ownerSpeed == 0 ? std::numeric_limits<int64_t>::max()
+                                    : remaining * 1000 / ownerSpeed;
+    if (ownerEta <= eta || (victim && ownerEta <= victimEta)) {
+      continue;
+    }
+    victim = e;
+    victimEta = ownerEta;
+  }
+  if (!victim) {
+    return nullptr;
+  }
+  auto index = victim->segment->getIndex();
+  A2_LOG_INFO(fmt("CUID#%" PRId64 " - Stealing segment#%lu from CUID#%" PRId64,
+                  cuid, static_cast<unsigned long>(index), victim->cuid));
+  // The owner may hold other segments with HTTP pipelining.  Since
+  // the rest of its response no longer matches its segments, cancel
+  // all of them so that the owner restarts its download.
+  cancelSegment(victim->cuid);
+  return getSegmentWithIndex(cuid, index);
+}
+
 void SegmentMan::cancelSegmentInternal(cuid_t cuid,
                                        const std::shared_ptr<Segment>& segment)
 {
@@ -409,9 +487,11 @@ void SegmentMan::registerPeerStat(const std::shared_ptr<PeerStat>& peerStat)
 
 std::shared_ptr<PeerStat> SegmentMan::getPeerStat(cuid_t cuid) const
 {
-  for (auto& e : peerStats_) {
-    if (e->getCuid() == cuid) {
-      return e;
+  // Command may register new PeerStat each time it makes new
+  // connection.  Search from the back to get the latest one.
+  for (auto i = peerStats_.rbegin(), eoi = peerStats_.rend(); i != eoi; ++i) {
+    if ((*i)->getCuid() == cuid) {
+      return *i;
     }
   }
   return nullptr;
@@ -59,6 +59,8 @@ class FileEntry;
 struct SegmentEntry {
   cuid_t cuid;
   std::shared_ptr<Segment> segment;
+  // The time when the segment was assigned to the command.
+  Timer assignedTime;
 
   SegmentEntry(cuid_t cuid, const std::shared_ptr<Segment>& segment);
   ~SegmentEntry();
@@ -154,6 +156,18 @@ public:
   std::shared_ptr<Segment> getCleanSegmentIfOwnerIsIdle(cuid_t cuid,
                                                         size_t index);
 
+  // Takes over an in-flight segment from another command whose
+  // download speed is much slower than the command whose CUID is
+  // cuid.  Among the candidates, the segment which the current owner
+  // takes the longest time to finish is chosen.  The download speeds
+  // are taken from the registered PeerStats.  The owner of the
+  // segment cancels all its segments and cuid command acquires the
+  // ownership of the chosen one.  This
+  // function is intended to be called when no unused segment is
+  // available, so that the last segments are not held by the slowest
+  // connection.  If no such segment exists, returns null.
+  std::shared_ptr<Segment> stealSegment(cuid_t cuid);
+
   /**
    * Updates download status.
    */
@@ -205,6 +219,8 @@ public:
     return peerStats_;
   }
 
+  // Returns the most recently registered PeerStat for cuid.  If no
+  // such PeerStat exists, returns null.
   std::shared_ptr<PeerStat> getPeerStat(cuid_t cuid) const;
 
   // If there is slower PeerStat than given peerStat for the same
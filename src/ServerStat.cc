@@ -57,6 +57,7 @@ ServerStat::ServerStat(const std::string& hostname, const std::string& protocol)
       singleConnectionAvgSpeed_(0),
       multiConnectionAvgSpeed_(0),
       counter_(0),
+      failureRate_(0),
       status_(OK)
 {
 }
@@ -139,6 +140,18 @@ void ServerStat::updateMultiConnectionAvgSpeed(int downloadSpeed)
   multiConnectionAvgSpeed_ = (int)avgDownloadSpeed;
 }
 
+void ServerStat::setFailureRate(int failureRate)
+{
+  failureRate_ = failureRate;
+}
+
+void ServerStat::updateFailureRate(bool failed)
+{
+  // Same weight as the one used for the average speeds once enough
+  // samples are collected.
+  failureRate_ = (4 * failureRate_ + (failed ? 1000 : 0)) / 5;
+}
+
 void ServerStat::increaseCounter() { ++counter_; }
 
 void ServerStat::setCounter(int value) { counter_ = value; }
@@ -166,7 +179,11 @@ void ServerStat::setStatusInternal(STATUS status)
 
 void ServerStat::setOK() { setStatusInternal(OK); }
 
-void ServerStat::setError() { setStatusInternal(A2_ERROR); }
+void ServerStat::setError()
+{
+  setStatusInternal(A2_ERROR);
+  updateFailureRate(true);
+}
 
 bool ServerStat::operator<(const ServerStat& serverStat) const
 {
@@ -184,11 +201,11 @@ std::string ServerStat::toString() const
 {
   return fmt("host=%s, protocol=%s, dl_speed=%d, sc_avg_speed=%d,"
              " mc_avg_speed=%d, last_updated=%" PRId64
-             ", counter=%d, status=%s",
+             ", counter=%d, fail_rate=%d, status=%s",
              getHostname().c_str(), getProtocol().c_str(), getDownloadSpeed(),
              getSingleConnectionAvgSpeed(), getMultiConnectionAvgSpeed(),
              static_cast<int64_t>(getLastUpdated().getTimeFromEpoch()),
-             getCounter(), STATUS_STRING[getStatus()]);
+             getCounter(), getFailureRate(), STATUS_STRING[getStatus()]);
 }
 
 } // namespace aria2
@@ -67,7 +67,7 @@ public:
 
   int getDownloadSpeed() const { return downloadSpeed_; }
 
-  // update download speed and update lastUpdated_
+  // update download speed and update lastUpdated_.
   void updateDownloadSpeed(int downloadSpeed);
 
   // set download speed. This method doesn't update _lastUpdate.
@@ -83,6 +83,16 @@ public:
   void updateMultiConnectionAvgSpeed(int downloadSpeed);
   void setMultiConnectionAvgSpeed(int singleConnectionAvgSpeed);
 
+  // Returns the rate of failed attempts for this server, in the
+  // range [0, 1000].  It is an exponentially weighted moving average,
+  // so that recent results weigh more than older ones.
+  int getFailureRate() const { return failureRate_; }
+
+  // Records the result of a connection to this server.  setError()
+  // records a failure.
+  void updateFailureRate(bool failed);
+  void setFailureRate(int failureRate);
+
   int getCounter() const { return counter_; }
 
   void increaseCounter();
@@ -105,7 +115,8 @@ public:
 
   bool isError() const { return status_ == A2_ERROR; }
 
-  // set status ERROR and update lastUpdated_
+  // set status ERROR and update lastUpdated_.  This is also recorded
+  // as a failed attempt.
   void setError();
 
   bool operator<(const ServerStat& serverStat) const;
@@ -127,6 +138,8 @@ private:
 
   int counter_;
 
+  int failureRate_;
+
   STATUS status_;
 
   Time lastUpdated_;
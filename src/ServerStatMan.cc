@@ -121,6 +121,7 @@ namespace {
 enum Field {
   S_COUNTER,
   S_DL_SPEED,
+  S_FAIL_RATE,
   S_HOST,
   S_LAST_UPDATED,
   S_MC_AVG_SPEED,
@@ -131,8 +132,9 @@ enum Field {
 };
 
 const char* FIELD_NAMES[] = {
-    "counter",      "dl_speed", "host",         "last_updated",
-    "mc_avg_speed", "protocol", "sc_avg_speed", "status",
+    "counter",      "dl_speed",     "fail_rate", "host",
+    "last_updated", "mc_avg_speed", "protocol",  "sc_avg_speed",
+    "status",
 };
 } // namespace
 
@@ -219,6 +221,13 @@ bool ServerStatMan::load(const std::string& filename)
       }
       sstat->setCounter(uintval);
     }
+    // Old serverstat file doesn't contains FAIL_RATE
+    if (!m[S_FAIL_RATE].empty()) {
+      if (!util::parseUIntNoThrow(uintval, m[S_FAIL_RATE])) {
+        continue;
+      }
+      sstat->setFailureRate(std::min(uintval, 1000u));
+    }
     int32_t intval;
     if (!util::parseIntNoThrow(intval, m[S_LAST_UPDATED])) {
       continue;
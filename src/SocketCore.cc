@@ -48,6 +48,7 @@
 #include <cassert>
 #include <sstream>
 #include <array>
+#include <algorithm>
 
 #include "message.h"
 #include "DlRetryEx.h"
@@ -1252,6 +1253,101 @@ ssize_t SocketCore::readDataFrom(void* data, size_t len, Endpoint& sender)
   return r;
 }
 
+size_t SocketCore::readDataFromBatch(unsigned char* data, size_t len,
+                                     size_t num, size_t* lens,
+                                     Endpoint* senders)
+{
+#ifdef HAVE_RECVMMSG
+  wantRead_ = false;
+  wantWrite_ = false;
+  constexpr size_t MAX_BATCH = 16;
+  std::array<mmsghdr, MAX_BATCH> msgs;
+  std::array<iovec, MAX_BATCH> iovs;
+  std::array<sockaddr_union, MAX_BATCH> addrs;
+  num = std::min(num, MAX_BATCH);
+  for (size_t i = 0; i < num; ++i) {
+    iovs[i].iov_base = data + i * len;
+    iovs[i].iov_len = len;
+    memset(&msgs[i], 0, sizeof(msgs[i]));
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int r;
+  while ((r = recvmmsg(sockfd_, msgs.data(), num, 0, nullptr)) == -1 &&
+         A2_EINTR == SOCKET_ERRNO)
+    ;
+  int errNum = SOCKET_ERRNO;
+  if (r == -1) {
+    if (!A2_WOULDBLOCK(errNum)) {
+      throw DL_RETRY_EX(fmt(EX_SOCKET_RECV, errorMsg(errNum).c_str()));
+    }
+    wantRead_ = true;
+    return 0;
+  }
+  for (int i = 0; i < r; ++i) {
+    if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+      lens[i] = 0;
+    }
+    else {
+      lens[i] = msgs[i].msg_len;
+    }
+    senders[i] =
+        util::getNumericNameInfo(&addrs[i].sa, msgs[i].msg_hdr.msg_namelen);
+  }
+  return r;
+#else  // !HAVE_RECVMMSG
+  wantRead_ = false;
+  wantWrite_ = false;
+  size_t i;
+  for (i = 0; i < num; ++i) {
+    sockaddr_union sockaddr;
+    socklen_t sockaddrlen = sizeof(sockaddr);
+    bool truncated = false;
+    ssize_t r;
+#  ifdef __MINGW32__
+    while ((r = recvfrom(sockfd_, reinterpret_cast<char*>(data + i * len),
+                         len, 0, &sockaddr.sa, &sockaddrlen)) == -1 &&
+           A2_EINTR == SOCKET_ERRNO)
+      ;
+    // Windows reports truncated datagram as an error.
+    if (r == -1 && SOCKET_ERRNO == WSAEMSGSIZE) {
+      truncated = true;
+      r = len;
+    }
+#  else  // !__MINGW32__
+    iovec iov;
+    iov.iov_base = data + i * len;
+    iov.iov_len = len;
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &sockaddr;
+    msg.msg_namelen = sockaddrlen;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    while ((r = recvmsg(sockfd_, &msg, 0)) == -1 && A2_EINTR == SOCKET_ERRNO)
+      ;
+    sockaddrlen = msg.msg_namelen;
+    truncated = msg.msg_flags & MSG_TRUNC;
+#  endif // !__MINGW32__
+    if (r == -1) {
+      int errNum = SOCKET_ERRNO;
+      if (!A2_WOULDBLOCK(errNum)) {
+        throw DL_RETRY_EX(fmt(EX_SOCKET_RECV, errorMsg(errNum).c_str()));
+      }
+      if (i == 0) {
+        wantRead_ = true;
+      }
+      break;
+    }
+    lens[i] = truncated ? 0 : r;
+    senders[i] = util::getNumericNameInfo(&sockaddr.sa, sockaddrlen);
+  }
+  return i;
+#endif // !HAVE_RECVMMSG
+}
+
 std::string SocketCore::getSocketError() const
 {
   int error;
@@ -285,6 +285,16 @@ public:
   // sender.addr will be numerihost assigned.
   ssize_t readDataFrom(void* data, size_t len, Endpoint& sender);
 
+  // Reads at most num datagrams.  i-th datagram is stored in data +
+  // i * len, its length in lens[i] and its sender in senders[i].  If
+  // recvmmsg(2) is available, datagrams are read in one system call.
+  // The datagram which does not fit in len bytes is discarded and
+  // its length is set to 0.  Returns the number of datagrams
+  // read. If the underlying socket gets EAGAIN before any datagram is
+  // read, wantRead_ is set.
+  size_t readDataFromBatch(unsigned char* data, size_t len, size_t num,
+                           size_t* lens, Endpoint* senders);
+
 #ifdef ENABLE_SSL
   // Performs TLS server side handshake. If handshake is completed,
   // returns true. If handshake has not been done yet, returns false.
@@ -69,6 +69,11 @@ public:
   virtual TLSSessionSide getSide() const = 0;
   virtual bool getVerifyPeer() const = 0;
   virtual void setVerifyPeer(bool) = 0;
+
+  // Lets the sessions created from this context use kernel TLS when
+  // possible.  Returns false if the implementation does not support
+  // it.  The default implementation does nothing and returns false.
+  virtual bool enableKTLS() { return false; }
 };
 
 } // namespace aria2
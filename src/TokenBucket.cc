@@ -0,0 +1,94 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2006 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "TokenBucket.h"
+
+#include "wallclock.h"
+
+namespace aria2 {
+
+namespace {
+constexpr int64_t SCALE = 1000000;
+} // namespace
+
+TokenBucket::TokenBucket(int rate)
+    : tokens_(static_cast<int64_t>(rate) * SCALE),
+      rate_(rate),
+      lastRefill_(global::wallclock())
+{
+}
+
+void TokenBucket::setRate(int rate)
+{
+  rate_ = rate;
+  tokens_ = static_cast<int64_t>(rate) * SCALE;
+  lastRefill_ = global::wallclock();
+}
+
+void TokenBucket::refill()
+{
+  const auto& now = global::wallclock();
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                     lastRefill_.difference(now))
+                     .count();
+  lastRefill_ = now;
+  const int64_t capacity = static_cast<int64_t>(rate_) * SCALE;
+  // Avoid overflow after a long idle period.
+  if (elapsed > (capacity - tokens_) / rate_) {
+    tokens_ = capacity;
+  }
+  else {
+    tokens_ += rate_ * elapsed;
+  }
+}
+
+void TokenBucket::consume(size_t bytes)
+{
+  if (rate_ == 0) {
+    return;
+  }
+  refill();
+  tokens_ -= static_cast<int64_t>(bytes) * SCALE;
+}
+
+bool TokenBucket::exhausted()
+{
+  if (rate_ == 0) {
+    return false;
+  }
+  refill();
+  return tokens_ <= 0;
+}
+
+} // namespace aria2
@@ -0,0 +1,80 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2006 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_TOKEN_BUCKET_H
+#define D_TOKEN_BUCKET_H
+
+#include "common.h"
+
+#include "TimerA2.h"
+
+namespace aria2 {
+
+// Token bucket used to enforce transfer rate limits.  The bucket is
+// refilled at rate bytes per second and holds at most 1 second worth
+// of tokens.  Since we only know how many bytes were transferred after
+// the fact, consume() may push the bucket into debt; the transfer is
+// then held back until the debt is paid off.  This gives a steady rate
+// instead of the on/off pattern of comparing an averaged speed against
+// the limit.
+class TokenBucket {
+private:
+  // Tokens are kept in bytes * 1000000, so that refilling in short
+  // intervals does not lose fractional bytes.
+  int64_t tokens_;
+  int rate_;
+  Timer lastRefill_;
+
+  void refill();
+
+public:
+  explicit TokenBucket(int rate = 0);
+
+  // Sets refill rate in bytes per second.  0 means unlimited.  The
+  // bucket is filled up to its new capacity.
+  void setRate(int rate);
+
+  int getRate() const { return rate_; }
+
+  // Takes |bytes| tokens from the bucket.
+  void consume(size_t bytes);
+
+  // Returns true if rate is limited and no token is left.  Always
+  // returns false if rate is 0.
+  bool exhausted();
+};
+
+} // namespace aria2
+
+#endif // D_TOKEN_BUCKET_H
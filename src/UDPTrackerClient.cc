@@ -45,6 +45,23 @@ namespace aria2 {
 
 UDPTrackerClient::UDPTrackerClient() : numWatchers_(0) {}
 
+namespace {
+// A request is resent if no reply arrives within
+// UDPT_RESEND_TIMEOUT, and fails if no reply arrives within
+// UDPT_TIMEOUT after it is resent.
+constexpr auto UDPT_RESEND_TIMEOUT = 5_s;
+constexpr auto UDPT_TIMEOUT = 10_s;
+} // namespace
+
+namespace {
+Timer getDeadline(const std::shared_ptr<UDPTrackerRequest>& req)
+{
+  auto deadline = req->dispatched;
+  deadline.advance(req->failCount == 0 ? UDPT_RESEND_TIMEOUT : UDPT_TIMEOUT);
+  return deadline;
+}
+} // namespace
+
 namespace {
 template <typename InputIterator>
 void failRequest(InputIterator first, InputIterator last, int error)
@@ -56,6 +73,19 @@ void failRequest(InputIterator first, InputIterator last, int error)
 }
 } // namespace
 
+namespace {
+void failRequest(
+    const std::unordered_multimap<uint32_t,
+                                  std::shared_ptr<UDPTrackerRequest>>& reqs,
+    int error)
+{
+  for (auto& elem : reqs) {
+    elem.second->state = UDPT_STA_COMPLETE;
+    elem.second->error = error;
+  }
+}
+} // namespace
+
 namespace {
 uint32_t generateTransactionId()
 {
@@ -104,7 +134,7 @@ UDPTrackerClient::~UDPTrackerClient()
 {
   // Make all contained requests fail
   int error = UDPT_ERR_SHUTDOWN;
-  failRequest(inflightRequests_.begin(), inflightRequests_.end(), error);
+  failRequest(inflightRequests_, error);
   failRequest(pendingRequests_.begin(), pendingRequests_.end(), error);
   failRequest(connectRequests_.begin(), connectRequests_.end(), error);
 }
@@ -333,7 +363,8 @@ void UDPTrackerClient::requestSent(const Timer& now)
     break;
   }
   }
-  inflightRequests_.push_back(req);
+  inflightRequests_.emplace(req->transactionId, req);
+  inflightDeadlines_.emplace(getDeadline(req), req);
   pendingRequests_.pop_front();
 }
 
@@ -381,7 +412,7 @@ struct TimeoutCheck {
   {
     auto t = req->dispatched.difference(now);
     if (req->failCount == 0) {
-      if (t >= 5_s) {
+      if (t >= UDPT_RESEND_TIMEOUT) {
         switch (req->action) {
         case UDPT_ACT_CONNECT:
           A2_LOG_INFO(fmt("UDPT resend CONNECT to %s:%u transaction_id=%08x",
@@ -409,7 +440,7 @@ struct TimeoutCheck {
       }
     }
     else {
-      if (t >= 10_s) {
+      if (t >= UDPT_TIMEOUT) {
         switch (req->action) {
         case UDPT_ACT_CONNECT:
           A2_LOG_INFO(fmt("UDPT timeout CONNECT to %s:%u transaction_id=%08x",
@@ -454,10 +485,23 @@ struct TimeoutCheck {
 void UDPTrackerClient::handleTimeout(const Timer& now)
 {
   std::vector<std::shared_ptr<UDPTrackerRequest>> dest;
-  inflightRequests_.erase(std::remove_if(inflightRequests_.begin(),
-                                         inflightRequests_.end(),
-                                         TimeoutCheck(dest, this, now)),
-                          inflightRequests_.end());
+  TimeoutCheck check(dest, this, now);
+  // Requests are visited in the order they expire, and the loop stops
+  // at the first one which has not expired yet.  All requests to
+  // resend have the same timeout, so they are resent in the order
+  // they were sent first.
+  while (!inflightDeadlines_.empty() &&
+         check((*std::begin(inflightDeadlines_)).second)) {
+    auto req = (*std::begin(inflightDeadlines_)).second;
+    inflightDeadlines_.erase(std::begin(inflightDeadlines_));
+    auto range = inflightRequests_.equal_range(req->transactionId);
+    for (auto i = range.first; i != range.second; ++i) {
+      if ((*i).second == req) {
+        inflightRequests_.erase(i);
+        break;
+      }
+    }
+  }
   pendingRequests_.insert(pendingRequests_.begin(), dest.begin(), dest.end());
 }
 
@@ -467,12 +511,13 @@ UDPTrackerClient::findInflightRequest(const std::string& remoteAddr,
                                       uint32_t transactionId, bool remove)
 {
   std::shared_ptr<UDPTrackerRequest> res;
-  for (auto i = inflightRequests_.begin(), eoi = inflightRequests_.end();
-       i != eoi; ++i) {
-    if ((*i)->remoteAddr == remoteAddr && (*i)->remotePort == remotePort &&
-        (*i)->transactionId == transactionId) {
-      res = *i;
+  auto range = inflightRequests_.equal_range(transactionId);
+  for (auto i = range.first; i != range.second; ++i) {
+    if ((*i).second->remoteAddr == remoteAddr &&
+        (*i).second->remotePort == remotePort) {
+      res = (*i).second;
       if (remove) {
+        removeInflightDeadline(res);
         inflightRequests_.erase(i);
       }
       break;
@@ -481,6 +526,18 @@ UDPTrackerClient::findInflightRequest(const std::string& remoteAddr,
   return res;
 }
 
+void UDPTrackerClient::removeInflightDeadline(
+    const std::shared_ptr<UDPTrackerRequest>& req)
+{
+  auto range = inflightDeadlines_.equal_range(getDeadline(req));
+  for (auto i = range.first; i != range.second; ++i) {
+    if ((*i).second == req) {
+      inflightDeadlines_.erase(i);
+      break;
+    }
+  }
+}
+
 UDPTrackerConnection*
 UDPTrackerClient::getConnectionId(const std::string& remoteAddr,
                                   uint16_t remotePort, const Timer& now)
@@ -543,7 +600,7 @@ void UDPTrackerClient::failConnect(const std::string& remoteAddr,
 void UDPTrackerClient::failAll()
 {
   int error = UDPT_ERR_SHUTDOWN;
-  failRequest(inflightRequests_.begin(), inflightRequests_.end(), error);
+  failRequest(inflightRequests_, error);
   failRequest(pendingRequests_.begin(), pendingRequests_.end(), error);
   failRequest(connectRequests_.begin(), connectRequests_.end(), error);
 }
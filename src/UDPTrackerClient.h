@@ -40,6 +40,7 @@
 #include <string>
 #include <deque>
 #include <map>
+#include <unordered_map>
 #include <memory>
 
 #include "TimerA2.h"
@@ -109,7 +110,7 @@ public:
   {
     return connectRequests_;
   }
-  const std::deque<std::shared_ptr<UDPTrackerRequest>>&
+  const std::unordered_multimap<uint32_t, std::shared_ptr<UDPTrackerRequest>>&
   getInflightRequests() const
   {
     return inflightRequests_;
@@ -142,9 +143,17 @@ private:
   UDPTrackerConnection* getConnectionId(const std::string& remoteAddr,
                                         uint16_t remotePort, const Timer& now);
 
+  void removeInflightDeadline(const std::shared_ptr<UDPTrackerRequest>& req);
+
   std::map<std::pair<std::string, uint16_t>, UDPTrackerConnection>
       connectionIdCache_;
-  std::deque<std::shared_ptr<UDPTrackerRequest>> inflightRequests_;
+  // Requests sent and waiting for reply, keyed by transaction ID.
+  // Transaction IDs are random, so they may collide across trackers.
+  std::unordered_multimap<uint32_t, std::shared_ptr<UDPTrackerRequest>>
+      inflightRequests_;
+  // The same requests keyed by the time they time out, so that
+  // handleTimeout() only visits the expired ones.
+  std::multimap<Timer, std::shared_ptr<UDPTrackerRequest>> inflightDeadlines_;
   std::deque<std::shared_ptr<UDPTrackerRequest>> pendingRequests_;
   std::deque<std::shared_ptr<UDPTrackerRequest>> connectRequests_;
   int numWatchers_;
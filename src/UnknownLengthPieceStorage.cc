@@ -122,6 +122,12 @@ std::shared_ptr<Piece> UnknownLengthPieceStorage::getMissingPiece(
 {
   abort();
 }
+
+bool UnknownLengthPieceStorage::getSuperSeedingPieceIndex(
+    size_t& index, const std::shared_ptr<Peer>& peer)
+{
+  return false;
+}
 #endif // ENABLE_BITTORRENT
 
 bool UnknownLengthPieceStorage::hasMissingUnusedPiece() { abort(); }
@@ -109,6 +109,10 @@ public:
   getMissingPiece(const std::shared_ptr<Peer>& peer,
                   const std::vector<size_t>& excludedIndexes,
                   cuid_t cuid) CXX11_OVERRIDE;
+
+  virtual bool
+  getSuperSeedingPieceIndex(size_t& index,
+                            const std::shared_ptr<Peer>& peer) CXX11_OVERRIDE;
 #endif // ENABLE_BITTORRENT
 
   virtual bool hasMissingUnusedPiece() CXX11_OVERRIDE;
@@ -62,6 +62,9 @@
 #include "SingletonHolder.h"
 #include "Notifier.h"
 #include "ApiCallbackDownloadEventListener.h"
+#include "CallbackDiskWriterFactory.h"
+#include "SocketCore.h"
+#include "Command.h"
 #ifdef ENABLE_BITTORRENT
 #  include "bittorrent_helper.h"
 #endif // ENABLE_BITTORRENT
@@ -69,7 +72,10 @@
 namespace aria2 {
 
 Session::Session(const KeyVals& options)
-    : context(std::make_shared<Context>(false, 0, nullptr, options))
+    : context(std::make_shared<Context>(false, 0, nullptr, options)),
+      stat(),
+      runFinished(false),
+      wakeupPort(0)
 {
 }
 
@@ -146,6 +152,17 @@ Session* sessionNew(const KeyVals& options, const SessionConfig& config)
 
 int sessionFinal(Session* session)
 {
+  if (session->runThread.joinable()) {
+    {
+      // Joining here would block forever if the thread keeps running
+      // the session.
+      std::lock_guard<std::mutex> lock(session->mutex);
+      if (!session->runFinished) {
+        return -1;
+      }
+    }
+    session->runThread.join();
+  }
   error_code::Value rv = session->context->reqinfo->getResult();
   delete session;
   return rv;
@@ -464,6 +481,55 @@ int changeOption(Session* session, A2Gid gid, const KeyVals& options)
   }
 }
 
+int setDownloadDataCallback(Session* session, A2Gid gid,
+                            DownloadDataCallback callback, void* userData)
+{
+  auto& e = session->context->reqinfo->getDownloadEngine();
+  std::shared_ptr<RequestGroup> group = e->getRequestGroupMan()->findGroup(gid);
+  if (!group || !callback || group->getState() != RequestGroup::STATE_WAITING) {
+    return -1;
+  }
+  auto& dctx = group->getDownloadContext();
+  if (dctx->getFileEntries().size() != 1) {
+    return -1;
+  }
+  // Verifying checksums requires reading the downloaded data back,
+  // but it is not kept once it is passed to the callback.
+  if (dctx->isChecksumVerificationAvailable() ||
+      dctx->isPieceHashVerificationAvailable()) {
+    return -1;
+  }
+#ifdef ENABLE_BITTORRENT
+  if (dctx->hasAttribute(CTX_ATTR_BT)) {
+    return -1;
+  }
+#endif // ENABLE_BITTORRENT
+  group->setDiskWriterFactory(std::make_shared<CallbackDiskWriterFactory>(
+      [session, gid, callback, userData](const unsigned char* data, size_t len,
+                                         int64_t offset) {
+        return callback(session, gid, offset, data, len, userData);
+      }));
+  group->setFileAllocationEnabled(false);
+  group->setPreLocalFileCheckEnabled(false);
+  group->markInMemoryDownload();
+  // Handlers for .torrent and Metalink files expect the data in
+  // memory or on disk.
+  group->clearPreDownloadHandler();
+  group->clearPostDownloadHandler();
+  group->getOption()->put(PREF_STREAM_PIECE_SELECTOR, V_INORDER);
+  // With several connections, a slow one lets the others run ahead
+  // until the pending data exceeds the limit of CallbackDiskWriter.
+  // The values of these options are copied when the group is
+  // created, so update the copies too, as changeOption() does.
+  group->getOption()->put(PREF_SPLIT, "1");
+  group->getOption()->put(PREF_MAX_CONNECTION_PER_SERVER, "1");
+  group->setNumConcurrentCommand(1);
+  for (auto& fileEntry : dctx->getFileEntries()) {
+    fileEntry->setMaxConnectionPerServer(1);
+  }
+  return 0;
+}
+
 const std::string& getGlobalOption(Session* session, const std::string& name)
 {
   auto& e = session->context->reqinfo->getDownloadEngine();
@@ -522,6 +588,155 @@ GlobalStat getGlobalStat(Session* session)
   return res;
 }
 
+namespace {
+// Drains the datagrams sent by postJob().  Receiving them makes the
+// event loop return from polling, so that runLoop() executes the
+// posted jobs immediately.
+class JobWakeupCommand : public Command {
+private:
+  DownloadEngine* e_;
+  std::shared_ptr<SocketCore> socket_;
+
+public:
+  JobWakeupCommand(cuid_t cuid, DownloadEngine* e,
+                   std::shared_ptr<SocketCore> socket)
+      : Command(cuid), e_(e), socket_(std::move(socket))
+  {
+    e_->addSocketForReadCheck(socket_, this);
+  }
+
+  virtual ~JobWakeupCommand() { e_->deleteSocketForReadCheck(socket_, this); }
+
+  virtual bool execute() CXX11_OVERRIDE
+  {
+    if (e_->getRequestGroupMan()->downloadFinished() || e_->isHaltRequested()) {
+      return true;
+    }
+    unsigned char buf[16];
+    Endpoint sender;
+    try {
+      while (socket_->readDataFrom(buf, sizeof(buf), sender) > 0)
+        ;
+    }
+    catch (RecoverableException& e) {
+      A2_LOG_DEBUG_EX("Failed to receive job wakeup", e);
+    }
+    e_->addCommand(std::unique_ptr<Command>(this));
+    return false;
+  }
+};
+
+void setupJobWakeup(Session* session)
+{
+  auto& e = session->context->reqinfo->getDownloadEngine();
+  try {
+    auto socket = std::make_shared<SocketCore>(SOCK_DGRAM);
+    socket->bind("127.0.0.1", 0, AF_INET);
+    socket->setNonBlockingMode();
+    auto wakeupSocket = std::make_shared<SocketCore>(SOCK_DGRAM);
+    wakeupSocket->create(AF_INET);
+    wakeupSocket->setNonBlockingMode();
+    session->wakeupPort = socket->getAddrInfo().port;
+    session->wakeupSocket = std::move(wakeupSocket);
+    e->addCommand(make_unique<JobWakeupCommand>(e->newCUID(), e.get(),
+                                                std::move(socket)));
+  }
+  catch (RecoverableException& ex) {
+    // Jobs are still executed after the poll timeout.
+    A2_LOG_INFO_EX("Failed to set up job wakeup socket", ex);
+  }
+}
+
+void runLoop(Session* session)
+{
+  std::vector<SessionJob> jobs;
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> lock(session->mutex);
+      jobs.swap(session->jobs);
+    }
+    for (auto& job : jobs) {
+      job(session);
+    }
+    jobs.clear();
+    int rv = run(session, RUN_ONCE);
+    auto stat = getGlobalStat(session);
+    {
+      std::lock_guard<std::mutex> lock(session->mutex);
+      session->stat = stat;
+    }
+    if (rv <= 0) {
+      break;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(session->mutex);
+    session->runFinished = true;
+    jobs.swap(session->jobs);
+  }
+  // postJob() has returned 0 for these jobs, so execute them.
+  for (auto& job : jobs) {
+    job(session);
+  }
+}
+} // namespace
+
+int startRunThread(Session* session)
+{
+  if (session->runThread.joinable()) {
+    return -1;
+  }
+  auto stat = getGlobalStat(session);
+  {
+    std::lock_guard<std::mutex> lock(session->mutex);
+    session->stat = stat;
+    session->runFinished = false;
+  }
+  if (!session->wakeupSocket) {
+    setupJobWakeup(session);
+  }
+  session->runThread = std::thread(runLoop, session);
+  return 0;
+}
+
+int postJob(Session* session, SessionJob job)
+{
+  if (!job) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(session->mutex);
+  if (session->runFinished) {
+    return -1;
+  }
+  session->jobs.push_back(std::move(job));
+  if (session->wakeupSocket) {
+    unsigned char c = 0;
+    try {
+      session->wakeupSocket->writeData(&c, 1, "127.0.0.1",
+                                       session->wakeupPort);
+    }
+    catch (RecoverableException& e) {
+      A2_LOG_DEBUG_EX("Failed to wake up the event loop", e);
+    }
+  }
+  return 0;
+}
+
+GlobalStat getGlobalStatSnapshot(Session* session)
+{
+  std::lock_guard<std::mutex> lock(session->mutex);
+  return session->stat;
+}
+
+int joinRunThread(Session* session)
+{
+  if (!session->runThread.joinable()) {
+    return -1;
+  }
+  session->runThread.join();
+  return 0;
+}
+
 std::vector<A2Gid> getActiveDownload(Session* session)
 {
   auto& e = session->context->reqinfo->getDownloadEngine();
@@ -38,12 +38,15 @@
 #include "common.h"
 
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <aria2/aria2.h>
 
 namespace aria2 {
 
 struct Context;
+class SocketCore;
 class ApiCallbackDownloadEventListener;
 
 struct Session {
@@ -51,6 +54,19 @@ struct Session {
   ~Session();
   std::shared_ptr<Context> context;
   std::unique_ptr<ApiCallbackDownloadEventListener> listener;
+  // The thread started by startRunThread().
+  std::thread runThread;
+  // Guards the members below, which are shared with runThread.
+  std::mutex mutex;
+  std::vector<SessionJob> jobs;
+  GlobalStat stat;
+  // true if runThread has stopped running the event loop.
+  bool runFinished;
+  // postJob() sends a datagram to wakeupPort through this socket, so
+  // that the event loop executes the job without waiting for the
+  // poll timeout.  null if the socket could not be set up.
+  std::shared_ptr<SocketCore> wakeupSocket;
+  uint16_t wakeupPort;
 };
 
 } // namespace aria2
@@ -35,6 +35,7 @@
 #include "bencode2.h"
 
 #include <sstream>
+#include <algorithm>
 
 #include "fmt.h"
 #include "DlAbortEx.h"
@@ -125,6 +126,97 @@ std::string encode(const ValueBase* vlb)
   return visitor.getResult();
 }
 
+namespace {
+// Returns the length of the bencoded value which starts at data, or 0
+// if data does not start with a complete bencoded value.
+size_t skipValue(const unsigned char* data, size_t len)
+{
+  size_t depth = 0;
+  size_t i = 0;
+  do {
+    if (i == len) {
+      return 0;
+    }
+    switch (data[i]) {
+    case 'i': {
+      auto last = std::find(data + i + 1, data + len, 'e');
+      if (last == data + len) {
+        return 0;
+      }
+      i = last - data + 1;
+      break;
+    }
+    case 'l':
+    case 'd':
+      ++depth;
+      ++i;
+      break;
+    case 'e':
+      if (depth == 0) {
+        return 0;
+      }
+      --depth;
+      ++i;
+      break;
+    default: {
+      if (!util::isDigit(data[i])) {
+        return 0;
+      }
+      size_t slen = 0;
+      for (; i < len && util::isDigit(data[i]); ++i) {
+        slen = slen * 10 + (data[i] - '0');
+        if (slen > len) {
+          return 0;
+        }
+      }
+      if (i == len || data[i] != ':' || len - i - 1 < slen) {
+        return 0;
+      }
+      i += 1 + slen;
+      break;
+    }
+    }
+  } while (depth > 0);
+  return i;
+}
+} // namespace
+
+bool findDictValue(size_t& offset, size_t& length, const unsigned char* data,
+                   size_t len, const std::string& key)
+{
+  if (len == 0 || data[0] != 'd') {
+    return false;
+  }
+  bool found = false;
+  size_t i = 1;
+  while (i < len && data[i] != 'e') {
+    if (!util::isDigit(data[i])) {
+      return false;
+    }
+    size_t keylen = skipValue(data + i, len - i);
+    if (keylen == 0) {
+      return false;
+    }
+    auto keyfirst = std::find(data + i, data + i + keylen, ':') + 1;
+    auto keylast = data + i + keylen;
+    size_t vstart = i + keylen;
+    size_t vlen = skipValue(data + vstart, len - vstart);
+    if (vlen == 0) {
+      return false;
+    }
+    if (static_cast<size_t>(keylast - keyfirst) == key.size() &&
+        std::equal(keyfirst, keylast, key.begin())) {
+      // Keep scanning.  Dict::put() overwrites the value of a
+      // duplicate key, so the last one is used by the decoded tree.
+      offset = vstart;
+      length = vlen;
+      found = true;
+    }
+    i = vstart + vlen;
+  }
+  return found && i < len;
+}
+
 } // namespace bencode2
 
 } // namespace aria2
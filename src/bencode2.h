@@ -59,6 +59,15 @@ std::unique_ptr<ValueBase> decodeFromFile(const std::string& filename);
 
 std::string encode(const ValueBase* vlb);
 
+// Scans the bencoded dictionary in data whose length is len and
+// finds the value associated with key without building ValueBase
+// objects.  If key appears more than once, the last one is used,
+// just like decode().  On success, stores the offset and the length
+// of the bencoded value in offset and length respectively, and
+// returns true.  Otherwise returns false.
+bool findDictValue(size_t& offset, size_t& length, const unsigned char* data,
+                   size_t len, const std::string& key);
+
 } // namespace bencode2
 
 } // namespace aria2
@@ -37,6 +37,7 @@
 #include <cassert>
 #include <cstring>
 #include <algorithm>
+#include <sstream>
 
 #include "DownloadContext.h"
 #include "Randomizer.h"
@@ -62,6 +63,7 @@
 #include "array_fun.h"
 #include "DownloadFailureException.h"
 #include "ValueBaseBencodeParser.h"
+#include "BufferedFile.h"
 
 namespace aria2 {
 
@@ -100,13 +102,8 @@ void extractPieceHash(const std::shared_ptr<DownloadContext>& ctx,
                       const std::string& hashData, size_t hashLength,
                       size_t numPieces)
 {
-  std::vector<std::string> pieceHashes;
-  pieceHashes.reserve(numPieces);
-  for (size_t i = 0; i < numPieces; ++i) {
-    const char* p = hashData.data() + i * hashLength;
-    pieceHashes.push_back(std::string(p, p + hashLength));
-  }
-  ctx->setPieceHashes("sha-1", pieceHashes.begin(), pieceHashes.end());
+  ctx->setPieceHashes("sha-1", hashData.substr(0, numPieces * hashLength),
+                      hashLength);
 }
 } // namespace
 
@@ -410,9 +407,11 @@ void extractNodes(TorrentAttribute* torrent, const ValueBase* nodesListSrc)
 } // namespace
 
 namespace {
+// If data is not nullptr, it must be the bencoded form of root whose
+// length is len.  It is used to take the info dictionary verbatim.
 void processRootDictionary(const std::shared_ptr<DownloadContext>& ctx,
-                           const ValueBase* root,
-                           const std::shared_ptr<Option>& option,
+                           const ValueBase* root, const unsigned char* data,
+                           size_t len, const std::shared_ptr<Option>& option,
                            const std::string& defaultName,
                            const std::string& overrideName,
                            const std::vector<std::string>& uris)
@@ -429,8 +428,17 @@ void processRootDictionary(const std::shared_ptr<DownloadContext>& ctx,
   }
   auto torrent = std::make_shared<TorrentAttribute>();
 
-  // retrieve infoHash
-  std::string encodedInfoDict = bencode2::encode(infoDict);
+  // retrieve infoHash.  Use the info dictionary as it appears in the
+  // torrent file if possible, so that we don't have to encode it again.
+  std::string encodedInfoDict;
+  size_t infoOffset, infoLength;
+  if (data &&
+      bencode2::findDictValue(infoOffset, infoLength, data, len, C_INFO)) {
+    encodedInfoDict.assign(data + infoOffset, data + infoOffset + infoLength);
+  }
+  else {
+    encodedInfoDict = bencode2::encode(infoDict);
+  }
   unsigned char infoHash[INFO_HASH_LENGTH];
   message_digest::digest(infoHash, INFO_HASH_LENGTH,
                          MessageDigest::sha1().get(), encodedInfoDict.data(),
@@ -533,9 +541,7 @@ void load(const std::string& torrentFile,
           const std::shared_ptr<Option>& option,
           const std::string& overrideName)
 {
-  ValueBaseBencodeParser parser;
-  processRootDictionary(ctx, parseFile(parser, torrentFile).get(), option,
-                        torrentFile, overrideName, std::vector<std::string>());
+  load(torrentFile, ctx, option, std::vector<std::string>(), overrideName);
 }
 
 void load(const std::string& torrentFile,
@@ -543,9 +549,23 @@ void load(const std::string& torrentFile,
           const std::shared_ptr<Option>& option,
           const std::vector<std::string>& uris, const std::string& overrideName)
 {
+  // Read the whole file at once so that the info dictionary can be
+  // taken from it without encoding.
+  std::stringstream ss;
+  BufferedFile fp(torrentFile.c_str(), BufferedFile::READ);
+  if (fp) {
+    fp.transfer(ss);
+  }
+  auto data = ss.str();
   ValueBaseBencodeParser parser;
-  processRootDictionary(ctx, parseFile(parser, torrentFile).get(), option,
-                        torrentFile, overrideName, uris);
+  ssize_t error;
+  auto root = parser.parseFinal(data.data(), data.size(), error);
+  if (error < 0) {
+    root.reset();
+  }
+  processRootDictionary(
+      ctx, root.get(), reinterpret_cast<const unsigned char*>(data.data()),
+      data.size(), option, torrentFile, overrideName, uris);
 }
 
 void loadFromMemory(const unsigned char* content, size_t length,
@@ -554,8 +574,8 @@ void loadFromMemory(const unsigned char* content, size_t length,
                     const std::string& defaultName,
                     const std::string& overrideName)
 {
-  processRootDictionary(ctx, bencode2::decode(content, length).get(), option,
-                        defaultName, overrideName, std::vector<std::string>());
+  loadFromMemory(content, length, ctx, option, std::vector<std::string>(),
+                 defaultName, overrideName);
 }
 
 void loadFromMemory(const unsigned char* content, size_t length,
@@ -565,8 +585,8 @@ void loadFromMemory(const unsigned char* content, size_t length,
                     const std::string& defaultName,
                     const std::string& overrideName)
 {
-  processRootDictionary(ctx, bencode2::decode(content, length).get(), option,
-                        defaultName, overrideName, uris);
+  processRootDictionary(ctx, bencode2::decode(content, length).get(), content,
+                        length, option, defaultName, overrideName, uris);
 }
 
 void loadFromMemory(const std::string& context,
@@ -575,8 +595,8 @@ void loadFromMemory(const std::string& context,
                     const std::string& defaultName,
                     const std::string& overrideName)
 {
-  processRootDictionary(ctx, bencode2::decode(context).get(), option,
-                        defaultName, overrideName, std::vector<std::string>());
+  loadFromMemory(context, ctx, option, std::vector<std::string>(), defaultName,
+                 overrideName);
 }
 
 void loadFromMemory(const std::string& context,
@@ -586,8 +606,10 @@ void loadFromMemory(const std::string& context,
                     const std::string& defaultName,
                     const std::string& overrideName)
 {
-  processRootDictionary(ctx, bencode2::decode(context).get(), option,
-                        defaultName, overrideName, uris);
+  processRootDictionary(
+      ctx, bencode2::decode(context).get(),
+      reinterpret_cast<const unsigned char*>(context.data()), context.size(),
+      option, defaultName, overrideName, uris);
 }
 
 void loadFromMemory(const ValueBase* torrent,
@@ -597,7 +619,8 @@ void loadFromMemory(const ValueBase* torrent,
                     const std::string& defaultName,
                     const std::string& overrideName)
 {
-  processRootDictionary(ctx, torrent, option, defaultName, overrideName, uris);
+  processRootDictionary(ctx, torrent, nullptr, 0, option, defaultName,
+                        overrideName, uris);
 }
 
 TorrentAttribute* getTorrentAttrs(const std::shared_ptr<DownloadContext>& dctx)
@@ -70,6 +70,190 @@ template <typename T> static forceinline T par(T b, T c, T d)
   w03 = endian(buffer[3]), w02 = endian(buffer[2]);                            \
   w01 = endian(buffer[1]), w00 = endian(buffer[0])
 
+// Intel SHA extensions.  Used for SHA-1 and SHA-256 when the CPU
+// supports them, which is checked at runtime, so that the same binary
+// still runs on older CPUs.
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    (defined(__clang__) || (defined(__GNUG__) && __GNUC__ >= 5))
+#  define HASH_HAVE_SHA_NI 1
+#endif
+
+#ifdef HASH_HAVE_SHA_NI
+#  include <cpuid.h>
+#  include <immintrin.h>
+
+static bool detectSHAExtensions()
+{
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) ||
+      !(ecx & bit_SSE4_1)) {
+    return false;
+  }
+  if (__get_cpuid_max(0, nullptr) < 7) {
+    return false;
+  }
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  return ebx & (1u << 29);
+}
+
+static const bool hasSHAExtensions = detectSHAExtensions();
+
+// One group of 4 rounds; g is the group number (0-19).  The message
+// schedule runs 1-3 groups ahead of the rounds.
+#  define __sha1ni_group(g, ecur, enext)                                       \
+    ecur = (g) == 0 ? _mm_add_epi32(ecur, msg[0])                             \
+                    : _mm_sha1nexte_epu32(ecur, msg[(g) % 4]);                \
+    enext = abcd;                                                             \
+    if ((g) >= 3 && (g) <= 18) {                                              \
+      msg[((g) + 1) % 4] =                                                    \
+          _mm_sha1msg2_epu32(msg[((g) + 1) % 4], msg[(g) % 4]);               \
+    }                                                                         \
+    abcd = _mm_sha1rnds4_epu32(abcd, ecur, (g) / 5);                          \
+    if ((g) >= 1 && (g) <= 16) {                                              \
+      msg[((g) + 3) % 4] =                                                    \
+          _mm_sha1msg1_epu32(msg[((g) + 3) % 4], msg[(g) % 4]);               \
+    }                                                                         \
+    if ((g) >= 2 && (g) <= 17) {                                              \
+      msg[((g) + 2) % 4] = _mm_xor_si128(msg[((g) + 2) % 4], msg[(g) % 4]);   \
+    }
+
+__attribute__((target("sha,sse4.1"))) static void
+sha1Transform(uint32_t* state, const void* block)
+{
+  const __m128i mask =
+      _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+  auto data = reinterpret_cast<const __m128i*>(block);
+
+  __m128i abcd = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+  __m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+  __m128i e1;
+  const __m128i abcdSave = abcd;
+  const __m128i e0Save = e0;
+
+  __m128i msg[4];
+  for (int i = 0; i < 4; ++i) {
+    msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(data + i), mask);
+  }
+
+  __sha1ni_group(0, e0, e1);
+  __sha1ni_group(1, e1, e0);
+  __sha1ni_group(2, e0, e1);
+  __sha1ni_group(3, e1, e0);
+  __sha1ni_group(4, e0, e1);
+  __sha1ni_group(5, e1, e0);
+  __sha1ni_group(6, e0, e1);
+  __sha1ni_group(7, e1, e0);
+  __sha1ni_group(8, e0, e1);
+  __sha1ni_group(9, e1, e0);
+  __sha1ni_group(10, e0, e1);
+  __sha1ni_group(11, e1, e0);
+  __sha1ni_group(12, e0, e1);
+  __sha1ni_group(13, e1, e0);
+  __sha1ni_group(14, e0, e1);
+  __sha1ni_group(15, e1, e0);
+  __sha1ni_group(16, e0, e1);
+  __sha1ni_group(17, e1, e0);
+  __sha1ni_group(18, e0, e1);
+  __sha1ni_group(19, e1, e0);
+
+  e0 = _mm_sha1nexte_epu32(e0, e0Save);
+  abcd = _mm_add_epi32(abcd, abcdSave);
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_shuffle_epi32(abcd, 0x1b));
+  state[4] = _mm_extract_epi32(e0, 3);
+}
+
+#  undef __sha1ni_group
+
+alignas(16) static const uint32_t sha256K[] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+// One group of 4 rounds; g is the group number (0-15).
+#  define __sha256ni_group(g)                                                  \
+    tmp = _mm_add_epi32(msg[(g) % 4],                                         \
+                        _mm_load_si128(reinterpret_cast<const __m128i*>(      \
+                            sha256K + (g) * 4)));                             \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, tmp);                      \
+    if ((g) >= 3 && (g) <= 14) {                                              \
+      msg[((g) + 1) % 4] = _mm_add_epi32(                                     \
+          msg[((g) + 1) % 4],                                                 \
+          _mm_alignr_epi8(msg[(g) % 4], msg[((g) + 3) % 4], 4));              \
+      msg[((g) + 1) % 4] =                                                    \
+          _mm_sha256msg2_epu32(msg[((g) + 1) % 4], msg[(g) % 4]);             \
+    }                                                                         \
+    state0 = _mm_sha256rnds2_epu32(state0, state1,                            \
+                                   _mm_shuffle_epi32(tmp, 0x0e));             \
+    if ((g) >= 1 && (g) <= 12) {                                              \
+      msg[((g) + 3) % 4] =                                                    \
+          _mm_sha256msg1_epu32(msg[((g) + 3) % 4], msg[(g) % 4]);             \
+    }
+
+__attribute__((target("sha,sse4.1"))) static void
+sha256Transform(uint32_t* state, const void* block)
+{
+  const __m128i mask =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  auto data = reinterpret_cast<const __m128i*>(block);
+
+  // The instructions want the state as ABEF and CDGH.
+  __m128i tmp = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+  __m128i state1 = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+  state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+  const __m128i abefSave = state0;
+  const __m128i cdghSave = state1;
+
+  __m128i msg[4];
+  for (int i = 0; i < 4; ++i) {
+    msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(data + i), mask);
+  }
+
+  __sha256ni_group(0);
+  __sha256ni_group(1);
+  __sha256ni_group(2);
+  __sha256ni_group(3);
+  __sha256ni_group(4);
+  __sha256ni_group(5);
+  __sha256ni_group(6);
+  __sha256ni_group(7);
+  __sha256ni_group(8);
+  __sha256ni_group(9);
+  __sha256ni_group(10);
+  __sha256ni_group(11);
+  __sha256ni_group(12);
+  __sha256ni_group(13);
+  __sha256ni_group(14);
+  __sha256ni_group(15);
+
+  state0 = _mm_add_epi32(state0, abefSave);
+  state1 = _mm_add_epi32(state1, cdghSave);
+
+  tmp = _mm_shuffle_epi32(state0, 0x1b);
+  state1 = _mm_shuffle_epi32(state1, 0xb1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_blend_epi16(tmp, state1, 0xf0));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4),
+                   _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#  undef __sha256ni_group
+
+#endif // HASH_HAVE_SHA_NI
+
 using namespace crypto;
 using namespace crypto::hash;
 
@@ -373,6 +557,13 @@ private:
 protected:
   virtual void transform(const word_t* buffer)
   {
+#ifdef HASH_HAVE_SHA_NI
+    if (likely(hasSHAExtensions)) {
+      sha1Transform(state_.words, buffer);
+      return;
+    }
+#endif // HASH_HAVE_SHA_NI
+
     __hash_assign_words(__crypto_be);
     __hash_maybe_memfence;
 
@@ -538,6 +729,13 @@ private:
 protected:
   virtual void transform(const word_t* buffer)
   {
+#ifdef HASH_HAVE_SHA_NI
+    if (likely(hasSHAExtensions)) {
+      sha256Transform(state_.words, buffer);
+      return;
+    }
+#endif // HASH_HAVE_SHA_NI
+
     __hash_assign_words(__crypto_be);
     __hash_maybe_memfence;
 
@@ -41,6 +41,7 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 
 // Libaria2: The aim of this library is provide same functionality
 // available in RPC methods. The function signatures are not
@@ -214,6 +215,11 @@ Session* sessionNew(const KeyVals& options, const SessionConfig& config);
  * destroys the |session| object, releasing the allocated resources
  * for it. This function returns the last error code and it is the
  * equivalent to the :ref:`exit-status` of :manpage:`aria2c(1)`.
+ *
+ * If the thread started by :func:`startRunThread()` is still running
+ * the |session|, this function returns negative error code without
+ * destroying the |session|. Queue a job which calls :func:`shutdown()`
+ * and call :func:`joinRunThread()` before this function.
  */
 int sessionFinal(Session* session);
 
@@ -428,6 +434,45 @@ int unpauseDownload(Session* session, A2Gid gid);
  */
 int changeOption(Session* session, A2Gid gid, const KeyVals& options);
 
+/**
+ * @functypedef
+ *
+ * Callback function invoked when downloaded data of the download
+ * denoted by the |gid| becomes available. The |data| holds |length|
+ * bytes which start at |offset| of the file. Data is passed in
+ * order, that is, |offset| is always the sum of the lengths passed
+ * so far. If the download is restarted from the beginning, |offset|
+ * starts over from 0. The |userData| is a pointer passed to
+ * :func:`setDownloadDataCallback()`.
+ *
+ * The implementation of this callback should return 0 if it
+ * succeeds. If it returns nonzero, the download is aborted.
+ */
+typedef int (*DownloadDataCallback)(Session* session, A2Gid gid,
+                                    int64_t offset, const uint8_t* data,
+                                    size_t length, void* userData);
+
+/**
+ * @function
+ *
+ * Makes the download denoted by the |gid| pass its data to the
+ * |callback| instead of writing it to the file. This function must
+ * be called while the download is in :c:macro:`DOWNLOAD_WAITING` or
+ * :c:macro:`DOWNLOAD_PAUSED` status. Only single file download is
+ * supported, and BitTorrent downloads, including Magnet URI, are not
+ * supported. Downloads which have a checksum or chunk checksums to
+ * verify, for example by :option:`checksum <--checksum>` option or
+ * Metalink, are not supported either. The download neither creates a
+ * control file nor resumes, and it uses a single connection so that
+ * data arrives in order. Data which arrives ahead of the data not
+ * passed yet is held in memory up to 15MiB; exceeding it aborts the
+ * download. The |userData| is passed to the |callback| as is.
+ *
+ * This function returns 0 if it succeeds, or negative error code.
+ */
+int setDownloadDataCallback(Session* session, A2Gid gid,
+                            DownloadDataCallback callback, void* userData);
+
 /**
  * @function
  *
@@ -513,6 +558,68 @@ struct GlobalStat {
  */
 GlobalStat getGlobalStat(Session* session);
 
+/**
+ * @typedef
+ *
+ * Function object which is executed by the thread running the
+ * session. See :func:`postJob()`.
+ */
+typedef std::function<void(Session* session)> SessionJob;
+
+/**
+ * @function
+ *
+ * Starts a thread which runs the |session| until :func:`run()`
+ * returns 0. After this call, the functions which take Session
+ * object must not be called from the other threads, except for
+ * :func:`postJob()`, :func:`getGlobalStatSnapshot()` and
+ * :func:`joinRunThread()`. Because the thread stops when no
+ * downloads are left, the |session| should be created with
+ * :member:`SessionConfig::keepRunning` set to true. The download
+ * event callback is invoked by this thread. This function returns 0
+ * if it succeeds, or negative error code if the thread has already
+ * been started.
+ */
+int startRunThread(Session* session);
+
+/**
+ * @function
+ *
+ * Queues the |job| to be executed by the thread started by
+ * :func:`startRunThread()`. Inside the |job|, any API function can be
+ * called with the given session, for example, :func:`addUri()` or
+ * :func:`shutdown()`. Jobs are executed in the order they are queued,
+ * between event pollings. Queuing a job wakes up the event polling
+ * through a UDP socket bound to 127.0.0.1, so the |job| is executed
+ * without waiting for the polling timeout. If the socket is not
+ * available, it may take up to 1 second until the |job| is
+ * executed. This function does not wait for the |job| and can be
+ * called from any thread, even before :func:`startRunThread()`. This
+ * function returns 0 if it succeeds, or negative error code if the
+ * thread has stopped running the session.
+ */
+int postJob(Session* session, SessionJob job);
+
+/**
+ * @function
+ *
+ * Returns global statistics recorded by the thread started by
+ * :func:`startRunThread()` after the last event polling. This
+ * function can be called from any thread.
+ */
+GlobalStat getGlobalStatSnapshot(Session* session);
+
+/**
+ * @function
+ *
+ * Waits for the thread started by :func:`startRunThread()` to
+ * finish. To make it finish, queue a job which calls
+ * :func:`shutdown()`. After this call, :func:`sessionFinal()` can be
+ * called. This function returns 0 if it succeeds, or negative error
+ * code.
+ */
+int joinRunThread(Session* session);
+
 /**
  * @enum
  *
@@ -196,6 +196,8 @@ PrefPtr PREF_STARTUP_IDLE_TIME = makePref("startup-idle-time");
 // value: prealloc | fallc | none
 PrefPtr PREF_FILE_ALLOCATION = makePref("file-allocation");
 // value: 1*digit
+PrefPtr PREF_FILE_ALLOCATION_THREADS = makePref("file-allocation-threads");
+// value: 1*digit
 PrefPtr PREF_NO_FILE_ALLOCATION_LIMIT = makePref("no-file-allocation-limit");
 // value: true | false
 PrefPtr PREF_ALLOW_OVERWRITE = makePref("allow-overwrite");
@@ -367,6 +369,8 @@ PrefPtr PREF_PAUSE_METADATA = makePref("pause-metadata");
 PrefPtr PREF_RLIMIT_NOFILE = makePref("rlimit-nofile");
 // values: SSLv3 | TLSv1 | TLSv1.1 | TLSv1.2
 PrefPtr PREF_MIN_TLS_VERSION = makePref("min-tls-version");
+// value: true | false
+PrefPtr PREF_ENABLE_KTLS = makePref("enable-ktls");
 // value: 1*digit
 PrefPtr PREF_SOCKET_RECV_BUFFER_SIZE = makePref("socket-recv-buffer-size");
 // value: 1*digit
@@ -525,6 +529,8 @@ PrefPtr PREF_BT_MAX_OPEN_FILES = makePref("bt-max-open-files");
 // values: true | false
 PrefPtr PREF_BT_SEED_UNVERIFIED = makePref("bt-seed-unverified");
 // values: true | false
+PrefPtr PREF_BT_SUPER_SEEDING = makePref("bt-super-seeding");
+// values: true | false
 PrefPtr PREF_BT_HASH_CHECK_SEED = makePref("bt-hash-check-seed");
 // values: 1*digit
 PrefPtr PREF_BT_MAX_PEERS = makePref("bt-max-peers");
@@ -150,6 +150,8 @@ extern PrefPtr PREF_STARTUP_IDLE_TIME;
 // value: prealloc | falloc | none
 extern PrefPtr PREF_FILE_ALLOCATION;
 // value: 1*digit
+extern PrefPtr PREF_FILE_ALLOCATION_THREADS;
+// value: 1*digit
 extern PrefPtr PREF_NO_FILE_ALLOCATION_LIMIT;
 // value: true | false
 extern PrefPtr PREF_ALLOW_OVERWRITE;
@@ -321,6 +323,8 @@ extern PrefPtr PREF_PAUSE_METADATA;
 extern PrefPtr PREF_RLIMIT_NOFILE;
 // values: SSLv3 | TLSv1 | TLSv1.1 | TLSv1.2
 extern PrefPtr PREF_MIN_TLS_VERSION;
+// value: true | false
+extern PrefPtr PREF_ENABLE_KTLS;
 // value: 1*digit
 extern PrefPtr PREF_SOCKET_RECV_BUFFER_SIZE;
 // value: 1*digit
@@ -476,6 +480,8 @@ extern PrefPtr PREF_BT_MAX_OPEN_FILES;
 // values: true | false
 extern PrefPtr PREF_BT_SEED_UNVERIFIED;
 // values: true | false
+extern PrefPtr PREF_BT_SUPER_SEEDING;
+// values: true | false
 extern PrefPtr PREF_BT_HASH_CHECK_SEED;
 // values: 1*digit
 extern PrefPtr PREF_BT_MAX_PEERS;
@@ -149,6 +149,10 @@
     "                              'trunc' uses ftruncate() system call or\n" \
     "                              platform-specific counterpart to truncate a file\n" \
     "                              to a specified length.")
+#define TEXT_FILE_ALLOCATION_THREADS                                    \
+  _(" --file-allocation-threads=NUM Allocate the files of a multi-file download\n" \
+    "                              using NUM threads in the background. 0 allocates\n" \
+    "                              files one by one in the main thread.")
 #define TEXT_NO_FILE_ALLOCATION_LIMIT                                   \
   _(" --no-file-allocation-limit=SIZE No file allocation is made for files whose\n" \
     "                              size is smaller than SIZE.\n"        \
@@ -376,6 +380,11 @@
 #define TEXT_BT_SEED_UNVERIFIED                                         \
   _(" --bt-seed-unverified[=true|false] Seed previously downloaded files without\n" \
     "                              verifying piece hashes.")
+#define TEXT_BT_SUPER_SEEDING                                           \
+  _(" --bt-super-seeding[=true|false] Advertise pieces one at a time to each\n" \
+    "                              peer while seeding, so that peers spread\n" \
+    "                              pieces among themselves and less upload\n" \
+    "                              is needed to seed a new torrent.")
 #define TEXT_BT_MAX_PEERS                                               \
   _(" --bt-max-peers=NUM           Specify the maximum number of peers per torrent.\n" \
     "                              0 means unlimited.\n"                \
@@ -1069,6 +1078,9 @@
     "                              recognized as active download in RPC method.")
 #define TEXT_MIN_TLS_VERSION                                            \
   _(" --min-tls-version=VERSION    Specify minimum SSL/TLS version to enable.")
+#define TEXT_ENABLE_KTLS                                                \
+  _(" --enable-ktls[=true|false]   Let the kernel encrypt and decrypt TLS records\n" \
+    "                              if the TLS library and the OS support it.")
 #define TEXT_BT_FORCE_ENCRYPTION                                        \
   _(" --bt-force-encryption[=true|false]\n"                             \
     "                              Requires BitTorrent message payload encryption\n" \
@@ -12,6 +12,7 @@ class ARC4Test : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(ARC4Test);
   CPPUNIT_TEST(testEncrypt);
+  CPPUNIT_TEST(testEncrypt_keystream);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -20,6 +21,7 @@ public:
   void tearDown() {}
 
   void testEncrypt();
+  void testEncrypt_keystream();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ARC4Test);
@@ -50,4 +52,27 @@ void ARC4Test::testEncrypt()
   CPPUNIT_ASSERT(memcmp(key, decrypted, LEN) == 0);
 }
 
+void ARC4Test::testEncrypt_keystream()
+{
+  // Test vector from RFC 6229
+  const unsigned char key[] = {0x01, 0x02, 0x03, 0x04, 0x05};
+  unsigned char data[32];
+  ARC4Encryptor enc;
+  enc.init(key, sizeof(key));
+  memset(data, 0, sizeof(data));
+  enc.encrypt(sizeof(data), data, data);
+  CPPUNIT_ASSERT_EQUAL(std::string("b2396305f03dc027ccc3524a0a1118a8"
+                                   "6982944f18fc82d589c403a47a0d0919"),
+                       util::toHex(data, sizeof(data)));
+  // Encrypting in pieces must produce the same keystream.
+  enc.init(key, sizeof(key));
+  memset(data, 0, sizeof(data));
+  enc.encrypt(1, data, data);
+  enc.encrypt(10, data + 1, data + 1);
+  enc.encrypt(21, data + 11, data + 11);
+  CPPUNIT_ASSERT_EQUAL(std::string("b2396305f03dc027ccc3524a0a1118a8"
+                                   "6982944f18fc82d589c403a47a0d0919"),
+                       util::toHex(data, sizeof(data)));
+}
+
 } // namespace aria2
@@ -1,5 +1,9 @@
 #include "aria2api.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "TestUtil.h"
@@ -10,6 +14,8 @@
 #include "Context.h"
 #include "MultiUrlRequestInfo.h"
 #include "DownloadEngine.h"
+#include "DownloadContext.h"
+#include "FileEntry.h"
 #include "Option.h"
 
 namespace aria2 {
@@ -24,7 +30,10 @@ class Aria2ApiTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testChangePosition);
   CPPUNIT_TEST(testChangeOption);
   CPPUNIT_TEST(testChangeGlobalOption);
+  CPPUNIT_TEST(testSetDownloadDataCallback);
   CPPUNIT_TEST(testDownloadResultDH);
+  CPPUNIT_TEST(testRunThread);
+  CPPUNIT_TEST(testRunThread_wakeup);
   CPPUNIT_TEST_SUITE_END();
 
   Session* session_;
@@ -46,7 +55,10 @@ public:
   void testChangePosition();
   void testChangeOption();
   void testChangeGlobalOption();
+  void testSetDownloadDataCallback();
   void testDownloadResultDH();
+  void testRunThread();
+  void testRunThread_wakeup();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(Aria2ApiTest);
@@ -223,6 +235,65 @@ void Aria2ApiTest::testChangeGlobalOption()
   CPPUNIT_ASSERT_EQUAL(-1, changeGlobalOption(session_, options));
 }
 
+namespace {
+int downloadDataCallback(Session* session, A2Gid gid, int64_t offset,
+                         const uint8_t* data, size_t length, void* userData)
+{
+  return 0;
+}
+} // namespace
+
+void Aria2ApiTest::testSetDownloadDataCallback()
+{
+  A2Gid gid;
+  std::vector<std::string> uris = {"http://localhost/1", "http://mirror1/1",
+                                   "http://mirror2/1"};
+  KeyVals options = {{"split", "5"}, {"max-connection-per-server", "4"}};
+  CPPUNIT_ASSERT_EQUAL(0, addUri(session_, &gid, uris, options));
+  CPPUNIT_ASSERT_EQUAL(0, setDownloadDataCallback(
+                              session_, gid, downloadDataCallback, nullptr));
+  auto group = session_->context->reqinfo->getDownloadEngine()
+                   ->getRequestGroupMan()
+                   ->findGroup(gid);
+  CPPUNIT_ASSERT_EQUAL(1, group->getNumConcurrentCommand());
+  CPPUNIT_ASSERT_EQUAL(1, group->getDownloadContext()
+                              ->getFirstFileEntry()
+                              ->getMaxConnectionPerServer());
+  options.clear();
+  uris.resize(1);
+
+  DownloadHandle* hd = getDownloadHandle(session_, gid);
+  CPPUNIT_ASSERT(hd);
+  CPPUNIT_ASSERT_EQUAL(std::string("inorder"),
+                       hd->getOption("stream-piece-selector"));
+  CPPUNIT_ASSERT_EQUAL(std::string("1"), hd->getOption("split"));
+  CPPUNIT_ASSERT_EQUAL(std::string("1"),
+                       hd->getOption("max-connection-per-server"));
+  deleteDownloadHandle(hd);
+
+  // failure with null gid
+  CPPUNIT_ASSERT_EQUAL(-1, setDownloadDataCallback(session_, (A2Gid)0,
+                                                   downloadDataCallback,
+                                                   nullptr));
+  // failure with null callback
+  CPPUNIT_ASSERT_EQUAL(
+      -1, setDownloadDataCallback(session_, gid, nullptr, nullptr));
+  // Download which has a checksum to verify is not supported
+  options.push_back(KeyVals::value_type(
+      "checksum", "sha-1=f36003f22b462ffa184390533c500d8989e9f681"));
+  CPPUNIT_ASSERT_EQUAL(0, addUri(session_, &gid, uris, options));
+  CPPUNIT_ASSERT_EQUAL(-1, setDownloadDataCallback(
+                               session_, gid, downloadDataCallback, nullptr));
+  options.clear();
+#ifdef ENABLE_BITTORRENT
+  // BitTorrent download is not supported
+  uris[0] = "magnet:?xt=urn:btih:248d0a1cd08284299de78d5c1ed359bb46717d8c";
+  CPPUNIT_ASSERT_EQUAL(0, addUri(session_, &gid, uris, options));
+  CPPUNIT_ASSERT_EQUAL(-1, setDownloadDataCallback(
+                               session_, gid, downloadDataCallback, nullptr));
+#endif // ENABLE_BITTORRENT
+}
+
 void Aria2ApiTest::testDownloadResultDH()
 {
   std::shared_ptr<DownloadResult> dr1 =
@@ -248,4 +319,74 @@ void Aria2ApiTest::testDownloadResultDH()
   deleteDownloadHandle(hd);
 }
 
+void Aria2ApiTest::testRunThread()
+{
+  CPPUNIT_ASSERT_EQUAL(-1, joinRunThread(session_));
+  CPPUNIT_ASSERT_EQUAL(-1, postJob(session_, SessionJob()));
+  std::vector<int> done;
+  CPPUNIT_ASSERT_EQUAL(0, postJob(session_, [&done](Session* session) {
+                         done.push_back(1);
+                       }));
+  CPPUNIT_ASSERT_EQUAL(0, postJob(session_, [&done](Session* session) {
+                         KeyVals options = {{"max-overall-download-limit",
+                                             "100K"}};
+                         done.push_back(changeGlobalOption(session, options));
+                       }));
+  CPPUNIT_ASSERT_EQUAL(0, startRunThread(session_));
+  // The thread stops because there is no download to perform.
+  CPPUNIT_ASSERT_EQUAL(0, joinRunThread(session_));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, done.size());
+  CPPUNIT_ASSERT_EQUAL(1, done[0]);
+  CPPUNIT_ASSERT_EQUAL(0, done[1]);
+  CPPUNIT_ASSERT_EQUAL(std::string("102400"),
+                       getGlobalOption(session_, "max-overall-download-limit"));
+  GlobalStat gs = getGlobalStatSnapshot(session_);
+  CPPUNIT_ASSERT_EQUAL(0, gs.numActive);
+  CPPUNIT_ASSERT_EQUAL(0, gs.numWaiting);
+  // The thread has stopped, so no job is accepted.
+  CPPUNIT_ASSERT_EQUAL(-1, postJob(session_, [&done](Session* session) {
+                          done.push_back(2);
+                        }));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, done.size());
+}
+
+void Aria2ApiTest::testRunThread_wakeup()
+{
+  sessionFinal(session_);
+  SessionConfig config;
+  config.keepRunning = true;
+  config.useSignalHandler = false;
+  KeyVals options = {{"no-conf", "true"}};
+  session_ = sessionNew(options, config);
+  CPPUNIT_ASSERT_EQUAL(0, startRunThread(session_));
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  int done = 0;
+  // Post jobs one after another, so that the thread is polling when
+  // each of them is posted.
+  for (int i = 1; i <= 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto start = std::chrono::steady_clock::now();
+    CPPUNIT_ASSERT_EQUAL(0, postJob(session_, [&](Session* session) {
+                           std::lock_guard<std::mutex> lock(mutex);
+                           ++done;
+                           cond.notify_all();
+                         }));
+    std::unique_lock<std::mutex> lock(mutex);
+    CPPUNIT_ASSERT(cond.wait_for(lock, std::chrono::seconds(5),
+                                 [&] { return done == i; }));
+    // The job must not wait for the poll timeout.
+    CPPUNIT_ASSERT(std::chrono::steady_clock::now() - start <
+                   std::chrono::milliseconds(300));
+  }
+  // The thread is still running the session.
+  CPPUNIT_ASSERT_EQUAL(-1, sessionFinal(session_));
+
+  CPPUNIT_ASSERT_EQUAL(0, postJob(session_, [](Session* session) {
+                         shutdown(session, false);
+                       }));
+  CPPUNIT_ASSERT_EQUAL(0, joinRunThread(session_));
+}
+
 } // namespace aria2
@@ -10,11 +10,13 @@ class Bencode2Test : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(Bencode2Test);
   CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST(testFindDictValue);
   CPPUNIT_TEST_SUITE_END();
 
 private:
 public:
   void testEncode();
+  void testFindDictValue();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(Bencode2Test);
@@ -42,4 +44,44 @@ void Bencode2Test::testEncode()
   }
 }
 
+void Bencode2Test::testFindDictValue()
+{
+  // Keys are not sorted so that re-encoding would change the bytes.
+  std::string data = "d"
+                     "4:name5:aria2"
+                     "4:infod6:lengthi-100e5:filesl2:ab0:ee"
+                     "3:loci80000e"
+                     "e";
+  auto p = reinterpret_cast<const unsigned char*>(data.data());
+  size_t offset, length;
+  CPPUNIT_ASSERT(bencode2::findDictValue(offset, length, p, data.size(),
+                                         "info"));
+  CPPUNIT_ASSERT_EQUAL(std::string("d6:lengthi-100e5:filesl2:ab0:ee"),
+                       data.substr(offset, length));
+  CPPUNIT_ASSERT(
+      bencode2::findDictValue(offset, length, p, data.size(), "loc"));
+  CPPUNIT_ASSERT_EQUAL(std::string("i80000e"), data.substr(offset, length));
+  CPPUNIT_ASSERT(
+      !bencode2::findDictValue(offset, length, p, data.size(), "length"));
+  // Truncated data
+  CPPUNIT_ASSERT(
+      !bencode2::findDictValue(offset, length, p, data.size() - 10, "loc"));
+  // String length exceeds the data
+  data = "d4:info99:xe";
+  p = reinterpret_cast<const unsigned char*>(data.data());
+  CPPUNIT_ASSERT(
+      !bencode2::findDictValue(offset, length, p, data.size(), "info"));
+  // Duplicate keys: the last one wins as Dict::put() does.
+  data = "d4:infoi1e3:loci2e4:infoi3ee";
+  p = reinterpret_cast<const unsigned char*>(data.data());
+  CPPUNIT_ASSERT(
+      bencode2::findDictValue(offset, length, p, data.size(), "info"));
+  CPPUNIT_ASSERT_EQUAL(std::string("i3e"), data.substr(offset, length));
+  // Not a dictionary
+  data = "l4:infoe";
+  p = reinterpret_cast<const unsigned char*>(data.data());
+  CPPUNIT_ASSERT(
+      !bencode2::findDictValue(offset, length, p, data.size(), "info"));
+}
+
 } // namespace aria2
@@ -49,6 +49,8 @@ class BittorrentHelperTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetFileEntries_singleFileUrlListEndsWithSlash);
   CPPUNIT_TEST(testLoadFromMemory);
   CPPUNIT_TEST(testLoadFromMemory_somethingMissing);
+  CPPUNIT_TEST(testLoadFromMemory_unsortedInfo);
+  CPPUNIT_TEST(testLoadFromMemory_duplicateInfo);
   CPPUNIT_TEST(testLoadFromMemory_overrideName);
   CPPUNIT_TEST(testLoadFromMemory_multiFileDirTraversal);
   CPPUNIT_TEST(testLoadFromMemory_singleFileDirTraversal);
@@ -108,6 +110,8 @@ public:
   void testGetFileEntries_singleFileUrlListEndsWithSlash();
   void testLoadFromMemory();
   void testLoadFromMemory_somethingMissing();
+  void testLoadFromMemory_unsortedInfo();
+  void testLoadFromMemory_duplicateInfo();
   void testLoadFromMemory_overrideName();
   void testLoadFromMemory_multiFileDirTraversal();
   void testLoadFromMemory_singleFileDirTraversal();
@@ -510,6 +514,43 @@ void BittorrentHelperTest::testLoadFromMemory()
   CPPUNIT_ASSERT_EQUAL(correctHash, getInfoHashString(dctx));
 }
 
+void BittorrentHelperTest::testLoadFromMemory_unsortedInfo()
+{
+  // The keys of info dictionary are not sorted.  Info hash must be
+  // calculated over the bytes as they appear in the torrent.
+  std::string info = "d4:name10:aria2-test12:piece lengthi128e"
+                     "6:lengthi100e6:pieces20:AAAAAAAAAAAAAAAAAAAAe";
+  std::string memory = "d8:announce15:http://tracker14:info" + info + "e";
+
+  auto dctx = std::make_shared<DownloadContext>();
+  loadFromMemory(memory, dctx, option_, "default");
+
+  CPPUNIT_ASSERT_EQUAL(std::string("fc412eb39981860c902b0f57b1aabcf2f78cfeaf"),
+                       getInfoHashString(dctx));
+  CPPUNIT_ASSERT(info == getTorrentAttrs(dctx)->metadata);
+}
+
+void BittorrentHelperTest::testLoadFromMemory_duplicateInfo()
+{
+  // The decoded tree keeps the last info dictionary.  Info hash and
+  // metadata must be taken from the same one.
+  std::string info = "d4:name10:aria2-test12:piece lengthi128e"
+                     "6:lengthi100e6:pieces20:AAAAAAAAAAAAAAAAAAAAe";
+  std::string memory = "d8:announce15:http://tracker1"
+                       "4:infod4:name5:decoy12:piece lengthi128e"
+                       "6:lengthi50e6:pieces20:BBBBBBBBBBBBBBBBBBBBe"
+                       "4:info" +
+                       info + "e";
+
+  auto dctx = std::make_shared<DownloadContext>();
+  loadFromMemory(memory, dctx, option_, "default");
+
+  CPPUNIT_ASSERT_EQUAL(std::string("fc412eb39981860c902b0f57b1aabcf2f78cfeaf"),
+                       getInfoHashString(dctx));
+  CPPUNIT_ASSERT(info == getTorrentAttrs(dctx)->metadata);
+  CPPUNIT_ASSERT_EQUAL((int64_t)100, dctx->getTotalLength());
+}
+
 void BittorrentHelperTest::testLoadFromMemory_somethingMissing()
 {
   // pieces missing
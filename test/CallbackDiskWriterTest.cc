@@ -0,0 +1,142 @@
+#include "CallbackDiskWriter.h"
+
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Exception.h"
+
+namespace aria2 {
+
+class CallbackDiskWriterTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(CallbackDiskWriterTest);
+  CPPUNIT_TEST(testWriteData);
+  CPPUNIT_TEST(testWriteData_overlap);
+  CPPUNIT_TEST(testReadData);
+  CPPUNIT_TEST(testWriteData_maxPendingLength);
+  CPPUNIT_TEST(testWriteData_callbackFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::string received_;
+  std::vector<int64_t> offsets_;
+  int result_;
+
+public:
+  void setUp()
+  {
+    received_.clear();
+    offsets_.clear();
+    result_ = 0;
+  }
+
+  CallbackDiskWriter::Callback callback()
+  {
+    return [this](const unsigned char* data, size_t len, int64_t offset) {
+      received_.append(data, data + len);
+      offsets_.push_back(offset);
+      return result_;
+    };
+  }
+
+  static void write(CallbackDiskWriter& dw, const std::string& s,
+                    int64_t offset)
+  {
+    dw.writeData(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                 offset);
+  }
+
+  void testWriteData();
+  void testWriteData_overlap();
+  void testReadData();
+  void testWriteData_maxPendingLength();
+  void testWriteData_callbackFailure();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CallbackDiskWriterTest);
+
+void CallbackDiskWriterTest::testWriteData()
+{
+  CallbackDiskWriter dw(callback());
+  dw.initAndOpenFile();
+  write(dw, "Hello", 0);
+  CPPUNIT_ASSERT_EQUAL(std::string("Hello"), received_);
+  write(dw, "!!", 11);
+  write(dw, "World", 6);
+  CPPUNIT_ASSERT_EQUAL(std::string("Hello"), received_);
+  CPPUNIT_ASSERT_EQUAL((size_t)7, dw.getPendingLength());
+  CPPUNIT_ASSERT_EQUAL((int64_t)13, dw.size());
+  write(dw, " ", 5);
+  CPPUNIT_ASSERT_EQUAL(std::string("Hello World!!"), received_);
+  CPPUNIT_ASSERT_EQUAL((size_t)4, offsets_.size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, offsets_[0]);
+  CPPUNIT_ASSERT_EQUAL((int64_t)5, offsets_[1]);
+  CPPUNIT_ASSERT_EQUAL((int64_t)6, offsets_[2]);
+  CPPUNIT_ASSERT_EQUAL((int64_t)11, offsets_[3]);
+  CPPUNIT_ASSERT_EQUAL((int64_t)13, dw.getDeliveredLength());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dw.getPendingLength());
+}
+
+void CallbackDiskWriterTest::testWriteData_overlap()
+{
+  CallbackDiskWriter dw(callback());
+  write(dw, "Hello", 0);
+  // Already delivered
+  write(dw, "ell", 1);
+  CPPUNIT_ASSERT_EQUAL(std::string("Hello"), received_);
+  // Partially delivered
+  write(dw, "lo World", 3);
+  CPPUNIT_ASSERT_EQUAL(std::string("Hello World"), received_);
+  CPPUNIT_ASSERT_EQUAL((int64_t)5, offsets_.back());
+  // Overlapping pending data
+  write(dw, "c!", 13);
+  write(dw, "abc", 11);
+  CPPUNIT_ASSERT_EQUAL(std::string("Hello Worldabc!"), received_);
+}
+
+void CallbackDiskWriterTest::testReadData()
+{
+  CallbackDiskWriter dw(callback());
+  write(dw, "Hello", 0);
+  write(dw, "World", 6);
+  unsigned char buf[16];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)3, dw.readData(buf, 3, 7));
+  CPPUNIT_ASSERT_EQUAL(std::string("orl"), std::string(&buf[0], &buf[3]));
+  CPPUNIT_ASSERT_EQUAL((ssize_t)2, dw.readData(buf, sizeof(buf), 9));
+  CPPUNIT_ASSERT_EQUAL((ssize_t)0, dw.readData(buf, sizeof(buf), 5));
+  CPPUNIT_ASSERT_EQUAL((ssize_t)0, dw.readData(buf, sizeof(buf), 11));
+  try {
+    dw.readData(buf, sizeof(buf), 0);
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (Exception& e) {
+  }
+}
+
+void CallbackDiskWriterTest::testWriteData_maxPendingLength()
+{
+  CallbackDiskWriter dw(callback(), 8);
+  write(dw, "Hello", 10);
+  try {
+    write(dw, "World", 20);
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (Exception& e) {
+  }
+  CPPUNIT_ASSERT(received_.empty());
+}
+
+void CallbackDiskWriterTest::testWriteData_callbackFailure()
+{
+  CallbackDiskWriter dw(callback());
+  result_ = -1;
+  try {
+    write(dw, "Hello", 0);
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (Exception& e) {
+  }
+}
+
+} // namespace aria2
@@ -13,6 +13,7 @@ class DHTConnectionImplTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(DHTConnectionImplTest);
   CPPUNIT_TEST(testWriteAndReadData);
+  CPPUNIT_TEST(testReadData_batch);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -21,6 +22,7 @@ public:
   void tearDown() {}
 
   void testWriteAndReadData();
+  void testReadData_batch();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DHTConnectionImplTest);
@@ -59,4 +61,46 @@ void DHTConnectionImplTest::testWriteAndReadData()
   }
 }
 
+void DHTConnectionImplTest::testReadData_batch()
+{
+  try {
+    DHTConnectionImpl con1(AF_INET);
+    uint16_t con1port = 0;
+    CPPUNIT_ASSERT(con1.bind(con1port, A2STR::NIL));
+
+    DHTConnectionImpl con2(AF_INET);
+    uint16_t con2port = 0;
+    CPPUNIT_ASSERT(con2.bind(con2port, A2STR::NIL));
+
+    std::string messages[] = {"alpha", std::string(10000, 'x'), "bravo",
+                              "charlie"};
+    for (auto& m : messages) {
+      con1.sendMessage(reinterpret_cast<const unsigned char*>(m.c_str()),
+                       m.size(), "localhost", con2port);
+    }
+
+    unsigned char readbuffer[100];
+    std::string remoteHost;
+    uint16_t remotePort;
+    while (!con2.getSocket()->isReadable(0))
+      ;
+    // Too large datagram is discarded.
+    for (auto& m : {messages[0], messages[2], messages[3]}) {
+      ssize_t rlength = 0;
+      while ((rlength = con2.receiveMessage(readbuffer, sizeof(readbuffer),
+                                            remoteHost, remotePort)) == 0)
+        ;
+      CPPUNIT_ASSERT_EQUAL(m,
+                           std::string(&readbuffer[0], &readbuffer[rlength]));
+      CPPUNIT_ASSERT_EQUAL(con1port, remotePort);
+    }
+    CPPUNIT_ASSERT_EQUAL((ssize_t)0,
+                         con2.receiveMessage(readbuffer, sizeof(readbuffer),
+                                             remoteHost, remotePort));
+  }
+  catch (Exception& e) {
+    CPPUNIT_FAIL(e.stackTrace());
+  }
+}
+
 } // namespace aria2
@@ -10,6 +10,7 @@
 #include "DHTMessageTrackerEntry.h"
 #include "DHTRoutingTable.h"
 #include "MockDHTMessageFactory.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -32,6 +33,24 @@ public:
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DHTMessageTrackerTest);
 
+namespace {
+class TimeoutRecorder : public MockDHTMessageCallback {
+public:
+  TimeoutRecorder(std::vector<std::shared_ptr<DHTNode>>* nodes) : nodes_(nodes)
+  {
+  }
+
+  virtual void
+  onTimeout(const std::shared_ptr<DHTNode>& remoteNode) CXX11_OVERRIDE
+  {
+    nodes_->push_back(remoteNode);
+  }
+
+private:
+  std::vector<std::shared_ptr<DHTNode>>* nodes_;
+};
+} // namespace
+
 void DHTMessageTrackerTest::testMessageArrived()
 {
   auto localNode = std::make_shared<DHTNode>();
@@ -95,6 +114,66 @@ void DHTMessageTrackerTest::testMessageArrived()
   }
 }
 
-void DHTMessageTrackerTest::testHandleTimeout() {}
+void DHTMessageTrackerTest::testHandleTimeout()
+{
+  global::wallclock().reset();
+
+  auto localNode = std::make_shared<DHTNode>();
+  auto routingTable = make_unique<DHTRoutingTable>(localNode);
+  auto factory = make_unique<MockDHTMessageFactory>();
+  factory->setLocalNode(localNode);
+
+  auto r1 = std::make_shared<DHTNode>();
+  r1->setIPAddress("192.168.0.1");
+  r1->setPort(6881);
+  auto r2 = std::make_shared<DHTNode>();
+  r2->setIPAddress("192.168.0.2");
+  r2->setPort(6882);
+  auto r3 = std::make_shared<DHTNode>();
+  r3->setIPAddress("192.168.0.3");
+  r3->setPort(6883);
+
+  auto m1 = make_unique<MockDHTMessage>(localNode, r1, "mock", "aa");
+  auto m2 = make_unique<MockDHTMessage>(localNode, r2, "mock", "bb");
+  // Same transaction ID as m1, but sent to another node.
+  auto m3 = make_unique<MockDHTMessage>(localNode, r3, "mock", "aa");
+
+  DHTMessageTracker tracker;
+  tracker.setRoutingTable(routingTable.get());
+  tracker.setMessageFactory(factory.get());
+  std::vector<std::shared_ptr<DHTNode>> timedout;
+  tracker.addMessage(m1.get(), 1_s, make_unique<TimeoutRecorder>(&timedout));
+  tracker.addMessage(m2.get(), 5_s, make_unique<TimeoutRecorder>(&timedout));
+  tracker.addMessage(m3.get(), 5_s, make_unique<TimeoutRecorder>(&timedout));
+
+  tracker.handleTimeout();
+  CPPUNIT_ASSERT_EQUAL((size_t)3, tracker.countEntry());
+
+  global::wallclock().advance(2_s);
+  tracker.handleTimeout();
+  CPPUNIT_ASSERT_EQUAL((size_t)2, tracker.countEntry());
+  CPPUNIT_ASSERT(!tracker.getEntryFor(m1.get()));
+  CPPUNIT_ASSERT(tracker.getEntryFor(m3.get()));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, timedout.size());
+  CPPUNIT_ASSERT(r1 == timedout[0]);
+
+  {
+    Dict resDict;
+    resDict.put("t", m2->getTransactionID());
+    auto p =
+        tracker.messageArrived(&resDict, r2->getIPAddress(), r2->getPort());
+    CPPUNIT_ASSERT(p.first);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, tracker.countEntry());
+  }
+
+  global::wallclock().advance(5_s);
+  tracker.handleTimeout();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, tracker.countEntry());
+  // m2 got a response, so it must not be timed out.
+  CPPUNIT_ASSERT_EQUAL((size_t)2, timedout.size());
+  CPPUNIT_ASSERT(r3 == timedout[1]);
+
+  global::wallclock().reset();
+}
 
 } // namespace aria2
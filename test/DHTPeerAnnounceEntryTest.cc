@@ -17,6 +17,7 @@ class DHTPeerAnnounceEntryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testRemoveStalePeerAddrEntry);
   CPPUNIT_TEST(testEmpty);
   CPPUNIT_TEST(testAddPeerAddrEntry);
+  CPPUNIT_TEST(testAddPeerAddrEntry_max);
   CPPUNIT_TEST(testGetPeers);
   CPPUNIT_TEST_SUITE_END();
 
@@ -24,6 +25,7 @@ public:
   void testRemoveStalePeerAddrEntry();
   void testEmpty();
   void testAddPeerAddrEntry();
+  void testAddPeerAddrEntry_max();
   void testGetPeers();
 };
 
@@ -84,6 +86,34 @@ void DHTPeerAnnounceEntryTest::testAddPeerAddrEntry()
   CPPUNIT_ASSERT(!entry.getPeerAddrEntries()[0].getLastUpdated().isZero());
 }
 
+void DHTPeerAnnounceEntryTest::testAddPeerAddrEntry_max()
+{
+  unsigned char infohash[DHT_ID_LENGTH];
+  memset(infohash, 0xff, DHT_ID_LENGTH);
+
+  DHTPeerAnnounceEntry entry(infohash);
+  entry.addPeerAddrEntry(PeerAddrEntry("192.168.0.1", 1024));
+  entry.addPeerAddrEntry(PeerAddrEntry("192.168.0.1", 1025, Timer::zero()));
+  for (size_t i = 2; i < DHT_MAX_PEER_ADDR_ENTRIES; ++i) {
+    entry.addPeerAddrEntry(PeerAddrEntry("192.168.0.1", 1024 + i));
+  }
+  CPPUNIT_ASSERT_EQUAL(DHT_MAX_PEER_ADDR_ENTRIES, entry.countPeerAddrEntry());
+
+  // The oldest one, port 1025, is replaced.
+  entry.addPeerAddrEntry(PeerAddrEntry("192.168.0.2", 6881));
+  CPPUNIT_ASSERT_EQUAL(DHT_MAX_PEER_ADDR_ENTRIES, entry.countPeerAddrEntry());
+  auto& entries = entry.getPeerAddrEntries();
+  CPPUNIT_ASSERT_EQUAL((uint16_t)1024, entries[0].getPort());
+  CPPUNIT_ASSERT_EQUAL((uint16_t)1026, entries[1].getPort());
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.2"),
+                       entries.back().getIPAddress());
+
+  std::vector<std::shared_ptr<Peer>> peers;
+  entry.getPeers(peers, 1);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, peers.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.2"), peers[0]->getIPAddress());
+}
+
 void DHTPeerAnnounceEntryTest::testGetPeers()
 {
   unsigned char infohash[DHT_ID_LENGTH];
@@ -11,6 +11,9 @@
 #include "Peer.h"
 #include "FileEntry.h"
 #include "bittorrent_helper.h"
+#include "MockDHTTaskQueue.h"
+#include "MockDHTTaskFactory.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -18,10 +21,22 @@ class DHTPeerAnnounceStorageTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(DHTPeerAnnounceStorageTest);
   CPPUNIT_TEST(testAddAnnounce);
+  CPPUNIT_TEST(testAddAnnounce_maxEntries);
+  CPPUNIT_TEST(testAddAnnounce_dropLeastRecentlyUpdated);
+  CPPUNIT_TEST(testGetPeers_maxValues);
+  CPPUNIT_TEST(testAnnouncePeer);
   CPPUNIT_TEST_SUITE_END();
 
 public:
+  void setUp() { global::wallclock().reset(); }
+
+  void tearDown() { global::wallclock().reset(); }
+
   void testAddAnnounce();
+  void testAddAnnounce_maxEntries();
+  void testAddAnnounce_dropLeastRecentlyUpdated();
+  void testGetPeers_maxValues();
+  void testAnnouncePeer();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DHTPeerAnnounceStorageTest);
@@ -47,4 +62,101 @@ void DHTPeerAnnounceStorageTest::testAddAnnounce()
   CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.4"), peers[1]->getIPAddress());
 }
 
+void DHTPeerAnnounceStorageTest::testAddAnnounce_maxEntries()
+{
+  DHTPeerAnnounceStorage storage;
+  unsigned char infohash[DHT_ID_LENGTH];
+  memset(infohash, 0, DHT_ID_LENGTH);
+  for (size_t i = 0; i <= DHT_MAX_PEER_ANNOUNCE_ENTRIES; ++i) {
+    infohash[0] = i >> 8;
+    infohash[1] = i & 0xff;
+    storage.addPeerAnnounce(infohash, "192.168.0.1", 6881);
+  }
+  CPPUNIT_ASSERT_EQUAL(DHT_MAX_PEER_ANNOUNCE_ENTRIES, storage.countEntry());
+  // The last one is always kept.
+  CPPUNIT_ASSERT(storage.contains(infohash));
+}
+
+void DHTPeerAnnounceStorageTest::testAddAnnounce_dropLeastRecentlyUpdated()
+{
+  DHTPeerAnnounceStorage storage;
+  unsigned char infohash[DHT_ID_LENGTH];
+  memset(infohash, 0, DHT_ID_LENGTH);
+  for (size_t i = 0; i < DHT_MAX_PEER_ANNOUNCE_ENTRIES; ++i) {
+    infohash[0] = i >> 8;
+    infohash[1] = i & 0xff;
+    storage.addPeerAnnounce(infohash, "192.168.0.1", 6881);
+  }
+  // Update the first entry, so that the second one becomes the least
+  // recently updated.
+  unsigned char infohash0[DHT_ID_LENGTH];
+  memset(infohash0, 0, DHT_ID_LENGTH);
+  storage.addPeerAnnounce(infohash0, "192.168.0.2", 6881);
+
+  unsigned char infohash1[DHT_ID_LENGTH];
+  memset(infohash1, 0, DHT_ID_LENGTH);
+  infohash1[1] = 1;
+  memset(infohash, 0xff, DHT_ID_LENGTH);
+  storage.addPeerAnnounce(infohash, "192.168.0.1", 6881);
+
+  CPPUNIT_ASSERT_EQUAL(DHT_MAX_PEER_ANNOUNCE_ENTRIES, storage.countEntry());
+  CPPUNIT_ASSERT(storage.contains(infohash));
+  CPPUNIT_ASSERT(storage.contains(infohash0));
+  CPPUNIT_ASSERT(!storage.contains(infohash1));
+
+  storage.addPeerAnnounce(infohash1, "192.168.0.1", 6881);
+
+  // Now the third one is dropped.
+  CPPUNIT_ASSERT(storage.contains(infohash1));
+  infohash1[1] = 2;
+  CPPUNIT_ASSERT(!storage.contains(infohash1));
+}
+
+void DHTPeerAnnounceStorageTest::testGetPeers_maxValues()
+{
+  DHTPeerAnnounceStorage storage;
+  unsigned char infohash[DHT_ID_LENGTH];
+  memset(infohash, 0xff, DHT_ID_LENGTH);
+  for (size_t i = 0; i < DHT_MAX_VALUES_SIZE + 5; ++i) {
+    storage.addPeerAnnounce(infohash, "192.168.0.1", 6881 + i);
+  }
+  std::vector<std::shared_ptr<Peer>> peers;
+  storage.getPeers(peers, infohash);
+  CPPUNIT_ASSERT_EQUAL(DHT_MAX_VALUES_SIZE, peers.size());
+  CPPUNIT_ASSERT_EQUAL((uint16_t)(6881 + DHT_MAX_VALUES_SIZE + 4),
+                       peers.back()->getPort());
+}
+
+void DHTPeerAnnounceStorageTest::testAnnouncePeer()
+{
+  MockDHTTaskQueue taskQueue;
+  MockDHTTaskFactory taskFactory;
+  DHTPeerAnnounceStorage storage;
+  storage.setTaskQueue(&taskQueue);
+  storage.setTaskFactory(&taskFactory);
+  unsigned char infohash1[DHT_ID_LENGTH];
+  memset(infohash1, 0xff, DHT_ID_LENGTH);
+  unsigned char infohash2[DHT_ID_LENGTH];
+  memset(infohash2, 0xf0, DHT_ID_LENGTH);
+  unsigned char infohash3[DHT_ID_LENGTH];
+  memset(infohash3, 0x0f, DHT_ID_LENGTH);
+  storage.addPeerAnnounce(infohash1, "192.168.0.1", 6881);
+  storage.addPeerAnnounce(infohash2, "192.168.0.1", 6881);
+  storage.addPeerAnnounce(infohash3, "192.168.0.1", 6881);
+
+  storage.announcePeer();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, taskQueue.periodicTaskQueue2_.size());
+
+  global::wallclock().advance(DHT_PEER_ANNOUNCE_INTERVAL);
+  // infohash2 was updated recently.
+  storage.addPeerAnnounce(infohash2, "192.168.0.2", 6881);
+
+  storage.announcePeer();
+  CPPUNIT_ASSERT_EQUAL((size_t)2, taskQueue.periodicTaskQueue2_.size());
+
+  // All entries were updated now.
+  storage.announcePeer();
+  CPPUNIT_ASSERT_EQUAL((size_t)2, taskQueue.periodicTaskQueue2_.size());
+}
+
 } // namespace aria2
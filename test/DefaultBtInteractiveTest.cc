@@ -0,0 +1,348 @@
+#include "DefaultBtInteractive.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "MockBtMessage.h"
+#include "MockBtMessageDispatcher.h"
+#include "MockBtMessageFactory.h"
+#include "MockBtRequestFactory.h"
+#include "MockPieceStorage.h"
+#include "BtMessageReceiver.h"
+#include "BtHandshakeMessage.h"
+#include "BtPieceMessage.h"
+#include "BtHaveMessage.h"
+#include "BtConstants.h"
+#include "BitfieldMan.h"
+#include "Peer.h"
+#include "Piece.h"
+#include "Option.h"
+#include "RequestGroup.h"
+#include "RequestGroupMan.h"
+#include "DownloadContext.h"
+#include "GroupId.h"
+#include "wallclock.h"
+#include "prefs.h"
+
+namespace aria2 {
+
+class DefaultBtInteractiveTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(DefaultBtInteractiveTest);
+  CPPUNIT_TEST(testUpdateMaxOutstandingRequest);
+  CPPUNIT_TEST(testUpdateMaxOutstandingRequest_slowPeer);
+  CPPUNIT_TEST(testUpdateMaxOutstandingRequest_reqq);
+  CPPUNIT_TEST(testSlowStart);
+  CPPUNIT_TEST(testSlowStart_reqq);
+  CPPUNIT_TEST(testSlowStart_stopWhenSpeedMeasured);
+  CPPUNIT_TEST(testCheckRequestSlot_endGame);
+  CPPUNIT_TEST(testCheckHave);
+  CPPUNIT_TEST(testCheckHave_peerHasPiece);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  class MockBtMessageDispatcher2 : public MockBtMessageDispatcher {
+  public:
+    size_t numOutstandingRequest;
+    int numCheckRequestSlot;
+
+    MockBtMessageDispatcher2()
+        : numOutstandingRequest{0}, numCheckRequestSlot{0}
+    {
+    }
+
+    virtual size_t countOutstandingRequest() CXX11_OVERRIDE
+    {
+      return numOutstandingRequest;
+    }
+
+    virtual void checkRequestSlotAndDoNecessaryThing() CXX11_OVERRIDE
+    {
+      ++numCheckRequestSlot;
+    }
+  };
+
+  // Delivers numPieceMessage piece messages, each of which completes
+  // one outstanding request.
+  class MockBtMessageReceiver : public BtMessageReceiver {
+  public:
+    MockBtMessageDispatcher2* dispatcher;
+    size_t numPieceMessage;
+
+    MockBtMessageReceiver(MockBtMessageDispatcher2* dispatcher)
+        : dispatcher{dispatcher}, numPieceMessage{0}
+    {
+    }
+
+    virtual std::unique_ptr<BtHandshakeMessage>
+    receiveHandshake(bool quickReply) CXX11_OVERRIDE
+    {
+      return nullptr;
+    }
+
+    virtual std::unique_ptr<BtHandshakeMessage>
+    receiveAndSendHandshake() CXX11_OVERRIDE
+    {
+      return nullptr;
+    }
+
+    virtual std::unique_ptr<BtMessage> receiveMessage() CXX11_OVERRIDE
+    {
+      if (numPieceMessage == 0) {
+        return nullptr;
+      }
+      --numPieceMessage;
+      if (dispatcher->numOutstandingRequest > 0) {
+        --dispatcher->numOutstandingRequest;
+      }
+      return make_unique<MockBtMessage>(uint8_t{BtPieceMessage::ID});
+    }
+  };
+
+  class MockBtRequestFactory2 : public MockBtRequestFactory {
+  public:
+    size_t lastMax;
+
+    MockBtRequestFactory2() : lastMax{0} {}
+
+    virtual std::vector<std::unique_ptr<BtRequestMessage>>
+    createRequestMessages(size_t max, bool endGame) CXX11_OVERRIDE
+    {
+      lastMax = max;
+      return std::vector<std::unique_ptr<BtRequestMessage>>{};
+    }
+  };
+
+  class MockBtMessageFactory2 : public MockBtMessageFactory {
+  public:
+    virtual std::unique_ptr<BtHaveMessage>
+    createHaveMessage(size_t index) CXX11_OVERRIDE
+    {
+      return make_unique<BtHaveMessage>(index);
+    }
+  };
+
+  class MockPieceStorage2 : public MockPieceStorage {
+  public:
+    std::vector<size_t> advertisedIndexes;
+
+    virtual bool hasMissingUnusedPiece() CXX11_OVERRIDE { return true; }
+
+    virtual uint64_t
+    getAdvertisedPieceIndexes(std::vector<size_t>& indexes, cuid_t myCuid,
+                              uint64_t lastHaveIndex) CXX11_OVERRIDE
+    {
+      indexes.insert(std::end(indexes), std::begin(advertisedIndexes),
+                     std::end(advertisedIndexes));
+      advertisedIndexes.clear();
+      return lastHaveIndex + indexes.size();
+    }
+  };
+
+private:
+  std::shared_ptr<Option> option_;
+  std::unique_ptr<RequestGroup> rg_;
+  std::unique_ptr<RequestGroupMan> rgman_;
+  std::shared_ptr<DownloadContext> dctx_;
+  std::unique_ptr<BitfieldMan> bitfieldMan_;
+  std::shared_ptr<MockPieceStorage2> pieceStorage_;
+  std::shared_ptr<Peer> peer_;
+  MockBtMessageDispatcher2* dispatcher_;
+  MockBtMessageReceiver* receiver_;
+  MockBtRequestFactory2* requestFactory_;
+  std::unique_ptr<DefaultBtInteractive> btInteractive_;
+
+public:
+  void setUp()
+  {
+    option_ = std::make_shared<Option>();
+    option_->put(PREF_DIR, ".");
+    rg_ = make_unique<RequestGroup>(GroupId::create(), option_);
+    dctx_ = std::make_shared<DownloadContext>(16_k, 16_k * 1000);
+    rg_->setDownloadContext(dctx_);
+    rgman_ = make_unique<RequestGroupMan>(
+        std::vector<std::shared_ptr<RequestGroup>>{}, 1, option_.get());
+
+    bitfieldMan_ = make_unique<BitfieldMan>(16_k, 16_k * 1000);
+    pieceStorage_ = std::make_shared<MockPieceStorage2>();
+    pieceStorage_->setBitfield(bitfieldMan_.get());
+
+    peer_ = std::make_shared<Peer>("192.168.0.1", 6969);
+    peer_->allocateSessionResource(16_k, 16_k * 1000);
+
+    btInteractive_ = make_unique<DefaultBtInteractive>(dctx_, peer_);
+    btInteractive_->setCuid(1);
+    btInteractive_->setPieceStorage(pieceStorage_);
+    btInteractive_->setRequestGroupMan(rgman_.get());
+    btInteractive_->setBtMessageFactory(make_unique<MockBtMessageFactory2>());
+    auto dispatcher = make_unique<MockBtMessageDispatcher2>();
+    dispatcher_ = dispatcher.get();
+    btInteractive_->setDispatcher(std::move(dispatcher));
+    auto receiver = make_unique<MockBtMessageReceiver>(dispatcher_);
+    receiver_ = receiver.get();
+    btInteractive_->setBtMessageReceiver(std::move(receiver));
+    auto requestFactory = make_unique<MockBtRequestFactory2>();
+    requestFactory_ = requestFactory.get();
+    btInteractive_->setBtRequestFactory(std::move(requestFactory));
+  }
+
+  // Completes all outstanding requests in one iteration and returns
+  // the maximum number of outstanding requests after it.
+  size_t completeOutstandingRequests()
+  {
+    receiver_->numPieceMessage = dispatcher_->numOutstandingRequest;
+    btInteractive_->doInteractionProcessing();
+    dispatcher_->numOutstandingRequest = requestFactory_->lastMax;
+    return requestFactory_->lastMax;
+  }
+
+  void testUpdateMaxOutstandingRequest();
+  void testUpdateMaxOutstandingRequest_slowPeer();
+  void testUpdateMaxOutstandingRequest_reqq();
+  void testSlowStart();
+  void testSlowStart_reqq();
+  void testSlowStart_stopWhenSpeedMeasured();
+  void testCheckRequestSlot_endGame();
+  void testCheckHave();
+  void testCheckHave_peerHasPiece();
+
+  std::vector<size_t> getQueuedHaveIndexes()
+  {
+    std::vector<size_t> indexes;
+    for (auto& msg : dispatcher_->messageQueue) {
+      auto have = dynamic_cast<BtHaveMessage*>(msg.get());
+      if (have) {
+        indexes.push_back(have->getIndex());
+      }
+    }
+    return indexes;
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DefaultBtInteractiveTest);
+
+void DefaultBtInteractiveTest::testUpdateMaxOutstandingRequest()
+{
+  // 160KiB/s for 3 seconds is 30 blocks.
+  peer_->updateDownload(160_k);
+  global::wallclock().advance(1_s);
+  CPPUNIT_ASSERT_EQUAL(160 * 1024, peer_->calculateDownloadSpeed());
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL((size_t)30, requestFactory_->lastMax);
+  CPPUNIT_ASSERT_EQUAL(1, dispatcher_->numCheckRequestSlot);
+
+  dispatcher_->numOutstandingRequest = 10;
+  global::wallclock().advance(1_s);
+  btInteractive_->doInteractionProcessing();
+  // The speed is now 80KiB/s, which is 15 blocks.
+  CPPUNIT_ASSERT_EQUAL((size_t)5, requestFactory_->lastMax);
+}
+
+void DefaultBtInteractiveTest::testUpdateMaxOutstandingRequest_slowPeer()
+{
+  peer_->updateDownload(1_k);
+  global::wallclock().advance(1_s);
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL(DEFAULT_MAX_OUTSTANDING_REQUEST,
+                       requestFactory_->lastMax);
+}
+
+void DefaultBtInteractiveTest::testUpdateMaxOutstandingRequest_reqq()
+{
+  peer_->updateDownload(160_k);
+  peer_->setMaxRequestQueue(20);
+  global::wallclock().advance(1_s);
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL((size_t)20, requestFactory_->lastMax);
+
+  // reqq larger than our upper bound does not raise the limit.
+  peer_->updateDownload(100_m);
+  peer_->setMaxRequestQueue(1000);
+  global::wallclock().advance(1_s);
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL(UB_MAX_OUTSTANDING_REQUEST, requestFactory_->lastMax);
+
+  // reqq 0 means the peer did not send it.
+  peer_->setMaxRequestQueue(0);
+  global::wallclock().advance(1_s);
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL(UB_MAX_OUTSTANDING_REQUEST, requestFactory_->lastMax);
+}
+
+void DefaultBtInteractiveTest::testSlowStart()
+{
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL(DEFAULT_MAX_OUTSTANDING_REQUEST,
+                       requestFactory_->lastMax);
+  dispatcher_->numOutstandingRequest = DEFAULT_MAX_OUTSTANDING_REQUEST;
+  CPPUNIT_ASSERT_EQUAL(DEFAULT_MAX_OUTSTANDING_REQUEST * 2,
+                       completeOutstandingRequests());
+  CPPUNIT_ASSERT_EQUAL(DEFAULT_MAX_OUTSTANDING_REQUEST * 4,
+                       completeOutstandingRequests());
+  // No request completed, so the window is not grown.
+  dispatcher_->numOutstandingRequest = 20;
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL(DEFAULT_MAX_OUTSTANDING_REQUEST * 4 - 20,
+                       requestFactory_->lastMax);
+}
+
+void DefaultBtInteractiveTest::testSlowStart_reqq()
+{
+  peer_->setMaxRequestQueue(8);
+  btInteractive_->doInteractionProcessing();
+  dispatcher_->numOutstandingRequest = requestFactory_->lastMax;
+  CPPUNIT_ASSERT_EQUAL((size_t)8, completeOutstandingRequests());
+  CPPUNIT_ASSERT_EQUAL((size_t)8, completeOutstandingRequests());
+}
+
+void DefaultBtInteractiveTest::testSlowStart_stopWhenSpeedMeasured()
+{
+  btInteractive_->doInteractionProcessing();
+  dispatcher_->numOutstandingRequest = requestFactory_->lastMax;
+  CPPUNIT_ASSERT_EQUAL(DEFAULT_MAX_OUTSTANDING_REQUEST * 2,
+                       completeOutstandingRequests());
+  // Once the speed of the peer is measured, the window is sized by
+  // updateMaxOutstandingRequest() only.
+  peer_->updateDownload(16_k);
+  CPPUNIT_ASSERT(peer_->calculateDownloadSpeed() > 0);
+  CPPUNIT_ASSERT_EQUAL(DEFAULT_MAX_OUTSTANDING_REQUEST * 2,
+                       completeOutstandingRequests());
+}
+
+void DefaultBtInteractiveTest::testCheckRequestSlot_endGame()
+{
+  // Outside of end game mode, request slots are checked once per
+  // second.
+  btInteractive_->doInteractionProcessing();
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL(0, dispatcher_->numCheckRequestSlot);
+
+  pieceStorage_->enterEndGame();
+  btInteractive_->doInteractionProcessing();
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT_EQUAL(2, dispatcher_->numCheckRequestSlot);
+}
+
+void DefaultBtInteractiveTest::testCheckHave()
+{
+  pieceStorage_->advertisedIndexes = {1, 2, 3};
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT((std::vector<size_t>{1, 2, 3}) == getQueuedHaveIndexes());
+}
+
+void DefaultBtInteractiveTest::testCheckHave_peerHasPiece()
+{
+  peer_->updateBitfield(1, 1);
+  peer_->updateBitfield(3, 1);
+  pieceStorage_->advertisedIndexes = {1, 2, 3};
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT((std::vector<size_t>{2}) == getQueuedHaveIndexes());
+
+  // Nothing is queued if the peer has all advertised pieces.
+  dispatcher_->messageQueue.clear();
+  pieceStorage_->advertisedIndexes = {1, 3};
+  btInteractive_->doInteractionProcessing();
+  CPPUNIT_ASSERT(getQueuedHaveIndexes().empty());
+  CPPUNIT_ASSERT(dispatcher_->messageQueue.empty());
+}
+
+} // namespace aria2
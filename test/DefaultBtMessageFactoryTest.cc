@@ -22,6 +22,7 @@ class DefaultBtMessageFactoryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DefaultBtMessageFactoryTest);
   CPPUNIT_TEST(testCreateBtMessage_BtExtendedMessage);
   CPPUNIT_TEST(testCreatePortMessage);
+  CPPUNIT_TEST(testCreateBtMessage_invalidHave);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -49,6 +50,7 @@ public:
 
   void testCreateBtMessage_BtExtendedMessage();
   void testCreatePortMessage();
+  void testCreateBtMessage_invalidHave();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DefaultBtMessageFactoryTest);
@@ -98,4 +100,19 @@ void DefaultBtMessageFactoryTest::testCreatePortMessage()
   }
 }
 
+void DefaultBtMessageFactoryTest::testCreateBtMessage_invalidHave()
+{
+  unsigned char data[9];
+  bittorrent::createPeerMessageString(data, sizeof(data), 5, 4);
+  // dctx_ has no pieces, so any index is out of range.
+  bittorrent::setIntParam(&data[5], 0);
+  try {
+    factory_->createBtMessage(&data[4], sizeof(data) - 4);
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (Exception& e) {
+    std::cerr << e.stackTrace() << std::endl;
+  }
+}
+
 } // namespace aria2
@@ -40,6 +40,7 @@ class DefaultPieceStorageTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetFilteredCompletedLength);
   CPPUNIT_TEST(testGetNextUsedIndex);
   CPPUNIT_TEST(testAdvertisePiece);
+  CPPUNIT_TEST(testGetSuperSeedingPieceIndex);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -79,6 +80,7 @@ public:
   void testGetFilteredCompletedLength();
   void testGetNextUsedIndex();
   void testAdvertisePiece();
+  void testGetSuperSeedingPieceIndex();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DefaultPieceStorageTest);
@@ -457,4 +459,35 @@ void DefaultPieceStorageTest::testAdvertisePiece()
   CPPUNIT_ASSERT_EQUAL((size_t)0, res.size());
 }
 
+void DefaultPieceStorageTest::testGetSuperSeedingPieceIndex()
+{
+  DefaultPieceStorage ps(dctx_, option_.get());
+  size_t index;
+  // We have no piece to advertise.
+  CPPUNIT_ASSERT(!ps.getSuperSeedingPieceIndex(index, peer));
+
+  ps.markAllPiecesDone();
+  ps.addPieceStats(0);
+  ps.addPieceStats(0);
+  ps.addPieceStats(1);
+  // The rarest piece first
+  CPPUNIT_ASSERT(ps.getSuperSeedingPieceIndex(index, peer));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, index);
+  // Pieces not advertised yet are preferred.
+  CPPUNIT_ASSERT(ps.getSuperSeedingPieceIndex(index, peer));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, index);
+  CPPUNIT_ASSERT(ps.getSuperSeedingPieceIndex(index, peer));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, index);
+  CPPUNIT_ASSERT(ps.getSuperSeedingPieceIndex(index, peer));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, index);
+
+  // Pieces the peer has are skipped.
+  peer->updateBitfield(1, 1);
+  peer->updateBitfield(2, 1);
+  CPPUNIT_ASSERT(ps.getSuperSeedingPieceIndex(index, peer));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, index);
+  peer->updateBitfield(0, 1);
+  CPPUNIT_ASSERT(!ps.getSuperSeedingPieceIndex(index, peer));
+}
+
 } // namespace aria2
@@ -54,10 +54,17 @@ void DownloadContextTest::testFindFileEntryByOffset()
 void DownloadContextTest::testGetPieceHash()
 {
   DownloadContext ctx;
-  const std::string pieceHashes[] = {"hash1", "hash2", "shash3"};
+  const std::string pieceHashes[] = {"hash1", "hash2", "hash3"};
   ctx.setPieceHashes("sha-1", &pieceHashes[0], &pieceHashes[3]);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, ctx.countPieceHash());
   CPPUNIT_ASSERT_EQUAL(std::string("hash1"), ctx.getPieceHash(0));
+  CPPUNIT_ASSERT_EQUAL(std::string("hash3"), ctx.getPieceHash(2));
   CPPUNIT_ASSERT_EQUAL(std::string(""), ctx.getPieceHash(3));
+
+  ctx.setPieceHashes("sha-1", "abcdefgh", 4);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, ctx.countPieceHash());
+  CPPUNIT_ASSERT_EQUAL(std::string("efgh"), ctx.getPieceHash(1));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), ctx.getPieceHash(2));
 }
 
 void DownloadContextTest::testGetNumPieces()
@@ -22,6 +22,7 @@ class FileEntryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testInsertUri);
   CPPUNIT_TEST(testRemoveUri);
   CPPUNIT_TEST(testPutBackRequest);
+  CPPUNIT_TEST(testCompact);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -39,6 +40,7 @@ public:
   void testInsertUri();
   void testRemoveUri();
   void testPutBackRequest();
+  void testCompact();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(FileEntryTest);
@@ -311,4 +313,26 @@ void FileEntryTest::testPutBackRequest()
   CPPUNIT_ASSERT_EQUAL(std::string("ftp://localhost/aria2.zip"), uris[2]);
 }
 
+void FileEntryTest::testCompact()
+{
+  std::vector<std::pair<size_t, std::string>> usedHosts;
+  InorderURISelector selector{};
+  FileEntry file;
+  file.addUri("http://example.org/");
+  file.addUri("http://example.net/");
+  auto req = file.getRequest(&selector, true, usedHosts);
+  file.poolRequest(req);
+  file.addURIResult("http://example.org/", error_code::TIME_OUT);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, file.countPooledRequest());
+
+  file.compact();
+
+  CPPUNIT_ASSERT_EQUAL((size_t)0, file.countPooledRequest());
+  CPPUNIT_ASSERT(file.getURIResults().empty());
+  auto uris = file.getUris();
+  CPPUNIT_ASSERT_EQUAL((size_t)2, uris.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("http://example.org/"), uris[0]);
+  CPPUNIT_ASSERT_EQUAL(std::string("http://example.net/"), uris[1]);
+}
+
 } // namespace aria2
@@ -107,6 +107,7 @@ void HandshakeExtensionMessageTest::testDoReceivedAction()
   msg.setExtension(ExtensionMessageRegistry::UT_PEX, 1);
   msg.setExtension(ExtensionMessageRegistry::UT_METADATA, 3);
   msg.setMetadataSize(1_k);
+  msg.setMaxRequestQueue(32);
   msg.setPeer(peer);
   msg.setDownloadContext(dctx.get());
 
@@ -118,6 +119,7 @@ void HandshakeExtensionMessageTest::testDoReceivedAction()
   CPPUNIT_ASSERT_EQUAL((uint8_t)3, peer->getExtensionMessageID(
                                        ExtensionMessageRegistry::UT_METADATA));
   CPPUNIT_ASSERT(peer->isSeeder());
+  CPPUNIT_ASSERT_EQUAL((size_t)32, peer->getMaxRequestQueue());
   auto attrs = bittorrent::getTorrentAttrs(dctx);
   CPPUNIT_ASSERT_EQUAL((size_t)1_k, attrs->metadataSize);
   CPPUNIT_ASSERT_EQUAL((int64_t)1_k, dctx->getTotalLength());
@@ -134,7 +136,8 @@ void HandshakeExtensionMessageTest::testDoReceivedAction()
 void HandshakeExtensionMessageTest::testCreate()
 {
   std::string in =
-      "0d1:pi6881e1:v5:aria21:md5:a2dhti2e6:ut_pexi1ee13:metadata_sizei1024ee";
+      "0d1:pi6881e1:v5:aria21:md5:a2dhti2e6:ut_pexi1ee13:metadata_sizei1024e"
+      "4:reqqi500ee";
   std::shared_ptr<HandshakeExtensionMessage> m(
       HandshakeExtensionMessage::create(
           reinterpret_cast<const unsigned char*>(in.c_str()), in.size()));
@@ -143,6 +146,8 @@ void HandshakeExtensionMessageTest::testCreate()
   CPPUNIT_ASSERT_EQUAL(
       (uint8_t)1, m->getExtensionMessageID(ExtensionMessageRegistry::UT_PEX));
   CPPUNIT_ASSERT_EQUAL((size_t)1_k, m->getMetadataSize());
+  // reqq is capped at UB_MAX_OUTSTANDING_REQUEST
+  CPPUNIT_ASSERT_EQUAL((size_t)256, m->getMaxRequestQueue());
   try {
     // bad payload format
     std::string in = "011:hello world";
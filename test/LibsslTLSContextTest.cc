@@ -0,0 +1,182 @@
+#include "LibsslTLSContext.h"
+
+#include <ctime>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "a2functional.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+class LibsslTLSContextTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(LibsslTLSContextTest);
+#if OPENSSL_101_API
+  CPPUNIT_TEST(testGetSession);
+  CPPUNIT_TEST(testGetSession_expired);
+  CPPUNIT_TEST(testAddSession_replace);
+  CPPUNIT_TEST(testAddSession_evictOldest);
+  CPPUNIT_TEST(testAddSession_evictExpired);
+#  ifdef TLS1_3_VERSION
+  CPPUNIT_TEST(testGetSession_tls13);
+#  endif // TLS1_3_VERSION
+#endif   // OPENSSL_101_API
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::unique_ptr<OpenSSLTLSContext> ctx_;
+
+public:
+  void setUp()
+  {
+    ctx_ = make_unique<OpenSSLTLSContext>(TLS_CLIENT, TLS_PROTO_TLS12);
+  }
+
+  void tearDown() {}
+
+#if OPENSSL_101_API
+  void testGetSession();
+  void testGetSession_expired();
+  void testAddSession_replace();
+  void testAddSession_evictOldest();
+  void testAddSession_evictExpired();
+#  ifdef TLS1_3_VERSION
+  void testGetSession_tls13();
+#  endif // TLS1_3_VERSION
+#endif   // OPENSSL_101_API
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LibsslTLSContextTest);
+
+#if OPENSSL_101_API
+namespace {
+SSL_SESSION* createSession(time_t t, long timeout = 3600,
+                           int version = TLS1_2_VERSION)
+{
+  auto session = SSL_SESSION_new();
+  SSL_SESSION_set_time(session, t);
+  SSL_SESSION_set_timeout(session, timeout);
+  SSL_SESSION_set_protocol_version(session, version);
+  return session;
+}
+} // namespace
+
+namespace {
+// Returns true if a usable session is cached for |key|.
+bool hasSession(OpenSSLTLSContext* ctx, const std::string& key)
+{
+  auto session = ctx->getSession(key);
+  if (!session) {
+    return false;
+  }
+  SSL_SESSION_free(session);
+  return true;
+}
+} // namespace
+
+void LibsslTLSContextTest::testGetSession()
+{
+  auto now = time(nullptr);
+  auto session = createSession(now);
+  ctx_->addSession("example.org:443", session);
+
+  CPPUNIT_ASSERT(!ctx_->getSession("example.org:8443"));
+  CPPUNIT_ASSERT(!ctx_->getSession("example.net:443"));
+
+  // TLSv1.2 session can be offered many times.
+  for (int i = 0; i < 2; ++i) {
+    auto s = ctx_->getSession("example.org:443");
+    CPPUNIT_ASSERT(session == s);
+    SSL_SESSION_free(s);
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)1, ctx_->getSessionCacheSize());
+}
+
+void LibsslTLSContextTest::testGetSession_expired()
+{
+  auto now = time(nullptr);
+  ctx_->addSession("example.org:443", createSession(now - 100, 10));
+
+  CPPUNIT_ASSERT(!ctx_->getSession("example.org:443"));
+  // Expired session is removed from the cache.
+  CPPUNIT_ASSERT_EQUAL((size_t)0, ctx_->getSessionCacheSize());
+}
+
+void LibsslTLSContextTest::testAddSession_replace()
+{
+  auto now = time(nullptr);
+  ctx_->addSession("example.org:443", createSession(now - 10));
+  auto session = createSession(now);
+  ctx_->addSession("example.org:443", session);
+
+  CPPUNIT_ASSERT_EQUAL((size_t)1, ctx_->getSessionCacheSize());
+  auto s = ctx_->getSession("example.org:443");
+  CPPUNIT_ASSERT(session == s);
+  SSL_SESSION_free(s);
+}
+
+void LibsslTLSContextTest::testAddSession_evictOldest()
+{
+  const size_t max = OpenSSLTLSContext::MAX_SESSION_CACHE_SIZE;
+  auto now = time(nullptr);
+  // Shuffle the age of sessions so that the oldest one is not simply
+  // the first one added.
+  for (size_t i = 0; i < max; ++i) {
+    auto t = now - 1000 + static_cast<time_t>(i * 3 % max);
+    ctx_->addSession(fmt("host%lu:443", static_cast<unsigned long>(i)),
+                     createSession(t));
+  }
+  CPPUNIT_ASSERT_EQUAL(max, ctx_->getSessionCacheSize());
+
+  ctx_->addSession("new:443", createSession(now));
+
+  CPPUNIT_ASSERT_EQUAL(max, ctx_->getSessionCacheSize());
+  CPPUNIT_ASSERT(hasSession(ctx_.get(), "new:443"));
+  // host0 has the smallest time.
+  CPPUNIT_ASSERT(!hasSession(ctx_.get(), "host0:443"));
+  for (size_t i = 1; i < max; ++i) {
+    CPPUNIT_ASSERT(hasSession(
+        ctx_.get(), fmt("host%lu:443", static_cast<unsigned long>(i))));
+  }
+}
+
+void LibsslTLSContextTest::testAddSession_evictExpired()
+{
+  const size_t max = OpenSSLTLSContext::MAX_SESSION_CACHE_SIZE;
+  auto now = time(nullptr);
+  for (size_t i = 0; i < max; ++i) {
+    // host100 and host200 have expired.
+    auto t = now - 1000 + static_cast<time_t>(i);
+    long timeout = i == 100 || i == 200 ? 1 : 3600;
+    ctx_->addSession(fmt("host%lu:443", static_cast<unsigned long>(i)),
+                     createSession(t, timeout));
+  }
+
+  ctx_->addSession("new:443", createSession(now));
+
+  // Both expired sessions were dropped, and the oldest live one was
+  // kept.
+  CPPUNIT_ASSERT_EQUAL(max - 1, ctx_->getSessionCacheSize());
+  CPPUNIT_ASSERT(hasSession(ctx_.get(), "host0:443"));
+  CPPUNIT_ASSERT(hasSession(ctx_.get(), "new:443"));
+}
+
+#  ifdef TLS1_3_VERSION
+void LibsslTLSContextTest::testGetSession_tls13()
+{
+  auto now = time(nullptr);
+  auto session = createSession(now, 3600, TLS1_3_VERSION);
+  ctx_->addSession("example.org:443", session);
+
+  auto s = ctx_->getSession("example.org:443");
+  CPPUNIT_ASSERT(session == s);
+  SSL_SESSION_free(s);
+  // TLSv1.3 ticket is used only once.
+  CPPUNIT_ASSERT_EQUAL((size_t)0, ctx_->getSessionCacheSize());
+  CPPUNIT_ASSERT(!ctx_->getSession("example.org:443"));
+}
+#  endif // TLS1_3_VERSION
+#endif   // OPENSSL_101_API
+
+} // namespace aria2
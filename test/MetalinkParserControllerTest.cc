@@ -243,15 +243,15 @@ void MetalinkParserControllerTest::testChunkChecksumTransaction()
     CPPUNIT_ASSERT_EQUAL((int32_t)256_k, md->getPieceLength());
     CPPUNIT_ASSERT_EQUAL((size_t)5, md->countPieceHash());
     CPPUNIT_ASSERT_EQUAL(std::string("1cbd18db4cc2f85cedef654fccc4a4d8"),
-                         md->getPieceHashes()[0]);
+                         md->getPieceHash(0));
     CPPUNIT_ASSERT_EQUAL(std::string("2cbd18db4cc2f85cedef654fccc4a4d8"),
-                         md->getPieceHashes()[1]);
+                         md->getPieceHash(1));
     CPPUNIT_ASSERT_EQUAL(std::string("3cbd18db4cc2f85cedef654fccc4a4d8"),
-                         md->getPieceHashes()[2]);
+                         md->getPieceHash(2));
     CPPUNIT_ASSERT_EQUAL(std::string("4cbd18db4cc2f85cedef654fccc4a4d8"),
-                         md->getPieceHashes()[3]);
+                         md->getPieceHash(3));
     CPPUNIT_ASSERT_EQUAL(std::string("5cbd18db4cc2f85cedef654fccc4a4d8"),
-                         md->getPieceHashes()[4]);
+                         md->getPieceHash(4));
 
     CPPUNIT_ASSERT(!m->getEntries()[1]->chunkChecksum);
 
@@ -292,13 +292,13 @@ void MetalinkParserControllerTest::testChunkChecksumTransactionV4()
     CPPUNIT_ASSERT_EQUAL((size_t)3, md->countPieceHash());
     CPPUNIT_ASSERT_EQUAL(
         std::string("5bd9f7248df0f3a6a86ab6c95f48787d546efa14"),
-        util::toHex(md->getPieceHashes()[0]));
+        util::toHex(md->getPieceHash(0)));
     CPPUNIT_ASSERT_EQUAL(
         std::string("9413ee70957a09d55704123687478e07f18c7b29"),
-        util::toHex(md->getPieceHashes()[1]));
+        util::toHex(md->getPieceHash(1)));
     CPPUNIT_ASSERT_EQUAL(
         std::string("44213f9f4d59b557314fadcd233232eebcac8012"),
-        util::toHex(md->getPieceHashes()[2]));
+        util::toHex(md->getPieceHash(2)));
 
     CPPUNIT_ASSERT(!m->getEntries()[1]->chunkChecksum);
 
@@ -94,6 +94,13 @@ public:
     return std::shared_ptr<Piece>(new Piece());
   }
 
+  virtual bool
+  getSuperSeedingPieceIndex(size_t& index,
+                            const std::shared_ptr<Peer>& peer) CXX11_OVERRIDE
+  {
+    return false;
+  }
+
 #endif // ENABLE_BITTORRENT
 
   virtual bool hasMissingUnusedPiece() CXX11_OVERRIDE { return false; }
@@ -19,6 +19,7 @@ class OptionTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testMerge);
   CPPUNIT_TEST(testParent);
   CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST(testCountLocal);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -33,6 +34,7 @@ public:
   void testMerge();
   void testParent();
   void testRemove();
+  void testCountLocal();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(OptionTest);
@@ -148,4 +150,27 @@ void OptionTest::testRemove()
   CPPUNIT_ASSERT(parent->defined(PREF_TIMEOUT));
 }
 
+void OptionTest::testCountLocal()
+{
+  Option op;
+  CPPUNIT_ASSERT(op.emptyLocal());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, op.countLocal());
+
+  op.put(PREF_TIMEOUT, "100");
+  op.put(PREF_DIR, "foo");
+  op.put(PREF_TIMEOUT, "200");
+  CPPUNIT_ASSERT_EQUAL((size_t)2, op.countLocal());
+  CPPUNIT_ASSERT_EQUAL(std::string("200"), op.get(PREF_TIMEOUT));
+  CPPUNIT_ASSERT_EQUAL(std::string("foo"), op.get(PREF_DIR));
+
+  op.removeLocal(PREF_TIMEOUT);
+  op.removeLocal(PREF_TIMEOUT);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, op.countLocal());
+  CPPUNIT_ASSERT_EQUAL(std::string("foo"), op.get(PREF_DIR));
+
+  op.clear();
+  CPPUNIT_ASSERT(op.emptyLocal());
+  CPPUNIT_ASSERT(!op.defined(PREF_DIR));
+}
+
 } // namespace aria2
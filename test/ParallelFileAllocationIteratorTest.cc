@@ -0,0 +1,134 @@
+#include "ParallelFileAllocationIterator.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "File.h"
+#include "MultiDiskAdaptor.h"
+#include "FileEntry.h"
+#include "RecoverableException.h"
+#include "TestUtil.h"
+
+namespace aria2 {
+
+class ParallelFileAllocationIteratorTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(ParallelFileAllocationIteratorTest);
+  CPPUNIT_TEST(testAllocate);
+  CPPUNIT_TEST(testAllocate_trunc);
+  CPPUNIT_TEST(testAllocate_error);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::vector<std::shared_ptr<FileEntry>>
+  createFileEntries(const std::string& storeDir);
+
+public:
+  void testAllocate();
+  void testAllocate_trunc();
+  void testAllocate_error();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParallelFileAllocationIteratorTest);
+
+std::vector<std::shared_ptr<FileEntry>>
+ParallelFileAllocationIteratorTest::createFileEntries(
+    const std::string& storeDir)
+{
+  auto fs = std::vector<std::shared_ptr<FileEntry>>{
+      std::make_shared<FileEntry>(storeDir + "/file1", 32769, 0),
+      std::make_shared<FileEntry>(storeDir + "/file2", 0, 32769),
+      std::make_shared<FileEntry>(storeDir + "/file3", 8, 32769),
+      std::make_shared<FileEntry>(storeDir + "/file4", 10, 32777), // req no
+      std::make_shared<FileEntry>(storeDir + "/file5", 20, 32787),
+      std::make_shared<FileEntry>(storeDir + "/file6", 30, 32807)}; // req no
+  fs[3]->setRequested(false);
+  fs[5]->setRequested(false);
+  for (auto& fe : fs) {
+    File{fe->getPath()}.remove();
+  }
+  return fs;
+}
+
+void ParallelFileAllocationIteratorTest::testAllocate()
+{
+  std::string storeDir =
+      A2_TEST_OUT_DIR "/aria2_ParallelFileAllocationIteratorTest_testAllocate";
+  auto fs = createFileEntries(storeDir);
+
+  MultiDiskAdaptor diskAdaptor;
+  diskAdaptor.setPieceLength(1);
+  diskAdaptor.setFileEntries(std::begin(fs), std::end(fs));
+  diskAdaptor.setFileAllocationThreads(2);
+  diskAdaptor.initAndOpenFile();
+
+  auto allocitr = diskAdaptor.fileAllocationIterator();
+  auto itr = dynamic_cast<ParallelFileAllocationIterator*>(allocitr.get());
+  CPPUNIT_ASSERT(itr);
+  CPPUNIT_ASSERT(itr->allocatesInBackground());
+  CPPUNIT_ASSERT(!itr->finished());
+  CPPUNIT_ASSERT_EQUAL((int64_t)32797, itr->getTotalLength());
+  while (!itr->finished()) {
+    itr->allocateChunk();
+  }
+  CPPUNIT_ASSERT_EQUAL((int64_t)32797, itr->getCurrentLength());
+  CPPUNIT_ASSERT_EQUAL((int64_t)32769, File(fs[0]->getPath()).size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, File(fs[1]->getPath()).size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)8, File(fs[2]->getPath()).size());
+  CPPUNIT_ASSERT(!File(fs[3]->getPath()).isFile());
+  CPPUNIT_ASSERT_EQUAL((int64_t)20, File(fs[4]->getPath()).size());
+  CPPUNIT_ASSERT(!File(fs[5]->getPath()).isFile());
+}
+
+void ParallelFileAllocationIteratorTest::testAllocate_trunc()
+{
+  std::string storeDir = A2_TEST_OUT_DIR
+      "/aria2_ParallelFileAllocationIteratorTest_testAllocate_trunc";
+  auto fs = createFileEntries(storeDir);
+
+  MultiDiskAdaptor diskAdaptor;
+  diskAdaptor.setPieceLength(1);
+  diskAdaptor.setFileEntries(std::begin(fs), std::end(fs));
+  diskAdaptor.setFileAllocationMethod(DiskAdaptor::FILE_ALLOC_TRUNC);
+  diskAdaptor.setFileAllocationThreads(8);
+  diskAdaptor.initAndOpenFile();
+
+  auto itr = diskAdaptor.fileAllocationIterator();
+  while (!itr->finished()) {
+    itr->allocateChunk();
+  }
+  CPPUNIT_ASSERT_EQUAL((int64_t)32769, File(fs[0]->getPath()).size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)8, File(fs[2]->getPath()).size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)20, File(fs[4]->getPath()).size());
+}
+
+void ParallelFileAllocationIteratorTest::testAllocate_error()
+{
+  std::string storeDir = A2_TEST_OUT_DIR
+      "/aria2_ParallelFileAllocationIteratorTest_testAllocate_error";
+  auto fs = createFileEntries(storeDir);
+
+  MultiDiskAdaptor diskAdaptor;
+  diskAdaptor.setPieceLength(1);
+  diskAdaptor.setFileEntries(std::begin(fs), std::end(fs));
+  diskAdaptor.setFileAllocationThreads(2);
+  diskAdaptor.initAndOpenFile();
+  diskAdaptor.closeFile();
+  // Opening a directory for writing fails in the worker thread.
+  File(fs[2]->getPath()).remove();
+  File(fs[2]->getPath()).mkdirs();
+
+  auto itr = diskAdaptor.fileAllocationIterator();
+  try {
+    while (!itr->finished()) {
+      itr->allocateChunk();
+    }
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (RecoverableException& e) {
+    // success
+  }
+  CPPUNIT_ASSERT(!itr->finished());
+  File(fs[2]->getPath()).remove();
+}
+
+} // namespace aria2
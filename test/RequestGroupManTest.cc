@@ -35,6 +35,7 @@ class RequestGroupManTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testFillRequestGroupFromReserver_uriParser);
   CPPUNIT_TEST(testInsertReservedGroup);
   CPPUNIT_TEST(testAddDownloadResult);
+  CPPUNIT_TEST(testRemoveStoppedGroup);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -67,6 +68,7 @@ public:
   void testFillRequestGroupFromReserver_uriParser();
   void testInsertReservedGroup();
   void testAddDownloadResult();
+  void testRemoveStoppedGroup();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RequestGroupManTest);
@@ -280,4 +282,43 @@ void RequestGroupManTest::testAddDownloadResult()
                        rgman_->getDownloadStat().getLastErrorResult());
 }
 
+void RequestGroupManTest::testRemoveStoppedGroup()
+{
+  auto rg1 =
+      createRequestGroup(0, 0, "foo1", "http://host/foo1", util::copy(option_));
+  auto rg2 =
+      createRequestGroup(0, 0, "foo2", "http://host/foo2", util::copy(option_));
+  auto rg3 =
+      createRequestGroup(0, 0, "foo3", "http://host/foo3", util::copy(option_));
+  rg1->increaseNumCommand();
+  rg2->increaseNumCommand();
+  rg1->setRequestGroupMan(rgman_);
+  rg2->setRequestGroupMan(rgman_);
+  rgman_->addRequestGroup(rg1);
+  rgman_->addRequestGroup(rg2);
+  // rg3 has no command, so it is removed at the next queue check.
+  rgman_->addRequestGroup(rg3);
+
+  rgman_->removeStoppedGroup(e_.get());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, rgman_->countRequestGroup());
+  CPPUNIT_ASSERT(!rgman_->findGroup(rg3->getGID()));
+
+  rgman_->clearQueueCheck();
+  rgman_->removeStoppedGroup(e_.get());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, rgman_->countRequestGroup());
+
+  rg2->decreaseNumCommand();
+  CPPUNIT_ASSERT(rgman_->queueCheckRequested());
+  // rg2 got another command before queue check; it must stay.
+  rg2->increaseNumCommand();
+  rgman_->removeStoppedGroup(e_.get());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, rgman_->countRequestGroup());
+
+  rg2->decreaseNumCommand();
+  rgman_->removeStoppedGroup(e_.get());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, rgman_->countRequestGroup());
+  CPPUNIT_ASSERT(rgman_->findGroup(rg1->getGID()));
+  CPPUNIT_ASSERT(!rgman_->findGroup(rg2->getGID()));
+}
+
 } // namespace aria2
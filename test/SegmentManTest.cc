@@ -10,6 +10,7 @@
 #include "PieceSelector.h"
 #include "FileEntry.h"
 #include "PeerStat.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -23,6 +24,9 @@ class SegmentManTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testCancelAllSegments);
   CPPUNIT_TEST(testGetPeerStat);
   CPPUNIT_TEST(testGetCleanSegmentIfOwnerIsIdle);
+  CPPUNIT_TEST(testStealSegment);
+  CPPUNIT_TEST(testStealSegment_pipelined);
+  CPPUNIT_TEST(testStealSegment_ownerNotMeasured);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -49,6 +53,9 @@ public:
   void testCancelAllSegments();
   void testGetPeerStat();
   void testGetCleanSegmentIfOwnerIsIdle();
+  void testStealSegment();
+  void testStealSegment_pipelined();
+  void testStealSegment_ownerNotMeasured();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SegmentManTest);
@@ -195,4 +202,91 @@ void SegmentManTest::testGetCleanSegmentIfOwnerIsIdle()
   CPPUNIT_ASSERT(!segmentMan_->getCleanSegmentIfOwnerIsIdle(5, 1));
 }
 
+void SegmentManTest::testStealSegment()
+{
+  std::shared_ptr<Segment> seg1 = segmentMan_->getSegmentWithIndex(1, 0);
+  std::shared_ptr<Segment> seg2 = segmentMan_->getSegmentWithIndex(2, 1);
+  seg2->updateWrittenLength(16_k);
+  // No PeerStat for CUID#3
+  CPPUNIT_ASSERT(!segmentMan_->stealSegment(3));
+
+  std::shared_ptr<PeerStat> peerStat1(new PeerStat(1));
+  peerStat1->downloadStart();
+  peerStat1->updateDownload(1000);
+  segmentMan_->registerPeerStat(peerStat1);
+  std::shared_ptr<PeerStat> peerStat2(new PeerStat(2));
+  peerStat2->downloadStart();
+  peerStat2->updateDownload(1);
+  segmentMan_->registerPeerStat(peerStat2);
+  std::shared_ptr<PeerStat> peerStat3(new PeerStat(3));
+  peerStat3->downloadStart();
+  peerStat3->updateDownload(100);
+  segmentMan_->registerPeerStat(peerStat3);
+
+  // CUID#1 is faster than CUID#3, so only segment#1 owned by CUID#2
+  // can be stolen.
+  std::shared_ptr<Segment> segment = segmentMan_->stealSegment(3);
+  CPPUNIT_ASSERT(segment);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, segment->getIndex());
+  CPPUNIT_ASSERT_EQUAL((int64_t)16_k, segment->getWrittenLength());
+  std::vector<std::shared_ptr<Segment>> segments;
+  segmentMan_->getInFlightSegment(segments, 2);
+  CPPUNIT_ASSERT(segments.empty());
+  segmentMan_->getInFlightSegment(segments, 3);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, segments.size());
+  // CUID#2 is too slow to steal anything.
+  CPPUNIT_ASSERT(!segmentMan_->stealSegment(2));
+}
+
+void SegmentManTest::testStealSegment_pipelined()
+{
+  // CUID#2 holds 2 segments because of HTTP pipelining.
+  segmentMan_->getSegmentWithIndex(2, 1);
+  segmentMan_->getSegmentWithIndex(2, 2);
+
+  std::shared_ptr<PeerStat> peerStat2(new PeerStat(2));
+  peerStat2->downloadStart();
+  peerStat2->updateDownload(1);
+  segmentMan_->registerPeerStat(peerStat2);
+  std::shared_ptr<PeerStat> peerStat3(new PeerStat(3));
+  peerStat3->downloadStart();
+  peerStat3->updateDownload(100);
+  segmentMan_->registerPeerStat(peerStat3);
+
+  std::shared_ptr<Segment> segment = segmentMan_->stealSegment(3);
+  CPPUNIT_ASSERT(segment);
+  // All segments of CUID#2 must be canceled, so that it restarts.
+  std::vector<std::shared_ptr<Segment>> segments;
+  segmentMan_->getInFlightSegment(segments, 2);
+  CPPUNIT_ASSERT(segments.empty());
+  segmentMan_->getInFlightSegment(segments, 3);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, segments.size());
+  // The segment which was not stolen is available again.
+  size_t other = segment->getIndex() == 1 ? 2 : 1;
+  CPPUNIT_ASSERT(segmentMan_->getSegmentWithIndex(4, other));
+}
+
+void SegmentManTest::testStealSegment_ownerNotMeasured()
+{
+  segmentMan_->getSegmentWithIndex(2, 1);
+  std::shared_ptr<PeerStat> peerStat3(new PeerStat(3));
+  peerStat3->downloadStart();
+  peerStat3->updateDownload(100);
+  segmentMan_->registerPeerStat(peerStat3);
+
+  // CUID#2 has just got the segment and has no PeerStat yet.
+  CPPUNIT_ASSERT(!segmentMan_->stealSegment(3));
+  std::shared_ptr<PeerStat> peerStat2(new PeerStat(2));
+  peerStat2->downloadStart();
+  segmentMan_->registerPeerStat(peerStat2);
+  CPPUNIT_ASSERT(!segmentMan_->stealSegment(3));
+
+  // CUID#2 has downloaded nothing for a while.
+  global::wallclock().advance(10_s);
+  peerStat3->updateDownload(1000);
+  std::shared_ptr<Segment> segment = segmentMan_->stealSegment(3);
+  CPPUNIT_ASSERT(segment);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, segment->getIndex());
+}
+
 } // namespace aria2
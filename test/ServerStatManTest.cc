@@ -74,6 +74,7 @@ void ServerStatManTest::testSave()
   std::shared_ptr<ServerStat> mirror(new ServerStat("mirror", "http"));
   mirror->setDownloadSpeed(0);
   mirror->setStatus(ServerStat::A2_ERROR);
+  mirror->setFailureRate(600);
   mirror->setLastUpdated(Time(1210000002));
 
   ServerStatMan ssm;
@@ -89,6 +90,7 @@ void ServerStatManTest::testSave()
                                    " mc_avg_speed=0,"
                                    " last_updated=1210000001,"
                                    " counter=0,"
+                                   " fail_rate=0,"
                                    " status=OK\n"
 
                                    "host=localhost, protocol=http,"
@@ -97,6 +99,7 @@ void ServerStatManTest::testSave()
                                    " mc_avg_speed=101,"
                                    " last_updated=1210000000,"
                                    " counter=5,"
+                                   " fail_rate=0,"
                                    " status=OK\n"
 
                                    "host=mirror, protocol=http,"
@@ -105,6 +108,7 @@ void ServerStatManTest::testSave()
                                    " mc_avg_speed=0,"
                                    " last_updated=1210000002,"
                                    " counter=0,"
+                                   " fail_rate=600,"
                                    " status=ERROR\n"),
                        readFile(filename));
 }
@@ -118,7 +122,7 @@ void ServerStatManTest::testLoad()
       "host=localhost, protocol=http, dl_speed=25000, sc_avg_speed=101, "
       "mc_avg_speed=102, last_updated=1210000000, counter=6, status=OK\n"
       "host=mirror, protocol=http, dl_speed=0, last_updated=1210000002, "
-      "status=ERROR\n";
+      "fail_rate=600, status=ERROR\n";
   BufferedFile fp(filename, BufferedFile::WRITE);
   CPPUNIT_ASSERT_EQUAL((size_t)in.size(), fp.write(in.data(), in.size()));
   CPPUNIT_ASSERT(fp.close() != EOF);
@@ -141,6 +145,11 @@ void ServerStatManTest::testLoad()
   std::shared_ptr<ServerStat> mirror = ssm.find("mirror", "http");
   CPPUNIT_ASSERT(mirror);
   CPPUNIT_ASSERT_EQUAL(ServerStat::A2_ERROR, mirror->getStatus());
+  CPPUNIT_ASSERT_EQUAL(600, mirror->getFailureRate());
+
+  std::shared_ptr<ServerStat> localhost_ftp = ssm.find("localhost", "ftp");
+  CPPUNIT_ASSERT(localhost_ftp);
+  CPPUNIT_ASSERT_EQUAL(0, localhost_ftp->getFailureRate());
 }
 
 void ServerStatManTest::testRemoveStaleServerStat()
@@ -156,6 +165,7 @@ void ServerStatManTest::testRemoveStaleServerStat()
   std::shared_ptr<ServerStat> mirror(new ServerStat("mirror", "http"));
   mirror->setDownloadSpeed(0);
   mirror->setStatus(ServerStat::A2_ERROR);
+  mirror->setFailureRate(600);
   mirror->setLastUpdated(Time(1210000002));
 
   ServerStatMan ssm;
@@ -15,6 +15,7 @@ class ServerStatTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ServerStatTest);
   CPPUNIT_TEST(testSetStatus);
   CPPUNIT_TEST(testToString);
+  CPPUNIT_TEST(testUpdateFailureRate);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -24,6 +25,7 @@ public:
 
   void testSetStatus();
   void testToString();
+  void testUpdateFailureRate();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ServerStatTest);
@@ -56,7 +58,7 @@ void ServerStatTest::testToString()
   CPPUNIT_ASSERT_EQUAL(
       std::string("host=localhost, protocol=http, dl_speed=90000,"
                   " sc_avg_speed=101, mc_avg_speed=102,"
-                  " last_updated=1000, counter=5, status=OK"),
+                  " last_updated=1000, counter=5, fail_rate=0, status=OK"),
       localhost_http.toString());
 
   ServerStat localhost_ftp("localhost", "ftp");
@@ -67,8 +69,25 @@ void ServerStatTest::testToString()
   CPPUNIT_ASSERT_EQUAL(
       std::string("host=localhost, protocol=ftp, dl_speed=10000,"
                   " sc_avg_speed=0, mc_avg_speed=0,"
-                  " last_updated=1210000000, counter=0, status=ERROR"),
+                  " last_updated=1210000000, counter=0, fail_rate=0,"
+                  " status=ERROR"),
       localhost_ftp.toString());
 }
 
+void ServerStatTest::testUpdateFailureRate()
+{
+  ServerStat ss("localhost", "http");
+  CPPUNIT_ASSERT_EQUAL(0, ss.getFailureRate());
+  ss.setError();
+  CPPUNIT_ASSERT_EQUAL(200, ss.getFailureRate());
+  ss.setError();
+  CPPUNIT_ASSERT_EQUAL(360, ss.getFailureRate());
+  ss.updateFailureRate(false);
+  CPPUNIT_ASSERT_EQUAL(288, ss.getFailureRate());
+  // The download speed is not a connection result.
+  ss.updateDownloadSpeed(100);
+  CPPUNIT_ASSERT_EQUAL(288, ss.getFailureRate());
+  CPPUNIT_ASSERT_EQUAL(ServerStat::OK, ss.getStatus());
+}
+
 } // namespace aria2
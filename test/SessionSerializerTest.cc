@@ -138,8 +138,10 @@ void SessionSerializerTest::testSaveErrorDownload()
 {
   std::shared_ptr<DownloadResult> dr =
       createDownloadResult(error_code::TIME_OUT, "http://error");
-  dr->fileEntries[0]->getSpentUris().swap(
-      dr->fileEntries[0]->getRemainingUris());
+  auto& remainingUris = dr->fileEntries[0]->getRemainingUris();
+  dr->fileEntries[0]->getSpentUris().assign(std::begin(remainingUris),
+                                            std::end(remainingUris));
+  remainingUris.clear();
   std::shared_ptr<Option> option(new Option());
   option->put(PREF_MAX_DOWNLOAD_RESULT, "10");
   RequestGroupMan rgman{std::vector<std::shared_ptr<RequestGroup>>(), 1,
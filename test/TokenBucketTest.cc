@@ -0,0 +1,77 @@
+#include "TokenBucket.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "wallclock.h"
+
+namespace aria2 {
+
+class TokenBucketTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(TokenBucketTest);
+  CPPUNIT_TEST(testConsume);
+  CPPUNIT_TEST(testUnlimited);
+  CPPUNIT_TEST(testSetRate);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() { global::wallclock().reset(); }
+
+  void tearDown() { global::wallclock().reset(); }
+
+  void testConsume();
+  void testUnlimited();
+  void testSetRate();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TokenBucketTest);
+
+void TokenBucketTest::testConsume()
+{
+  TokenBucket bucket(1000);
+  CPPUNIT_ASSERT(!bucket.exhausted());
+  bucket.consume(600);
+  CPPUNIT_ASSERT(!bucket.exhausted());
+  // Going into debt is allowed.
+  bucket.consume(1400);
+  CPPUNIT_ASSERT(bucket.exhausted());
+
+  // 1000 bytes are in debt; 0.5 seconds pays half of it.
+  global::wallclock().advance(500_ms);
+  CPPUNIT_ASSERT(bucket.exhausted());
+  // Refilling in small steps must not lose tokens.
+  for (int i = 0; i < 499; ++i) {
+    global::wallclock().advance(1_ms);
+    CPPUNIT_ASSERT(bucket.exhausted());
+  }
+  global::wallclock().advance(2_ms);
+  CPPUNIT_ASSERT(!bucket.exhausted());
+
+  // The bucket holds at most 1 second worth of tokens.
+  global::wallclock().advance(10_s);
+  bucket.consume(1000);
+  CPPUNIT_ASSERT(bucket.exhausted());
+}
+
+void TokenBucketTest::testUnlimited()
+{
+  TokenBucket bucket;
+  CPPUNIT_ASSERT_EQUAL(0, bucket.getRate());
+  bucket.consume(1000000);
+  CPPUNIT_ASSERT(!bucket.exhausted());
+}
+
+void TokenBucketTest::testSetRate()
+{
+  TokenBucket bucket(100);
+  bucket.consume(1000);
+  CPPUNIT_ASSERT(bucket.exhausted());
+  bucket.setRate(2000);
+  CPPUNIT_ASSERT_EQUAL(2000, bucket.getRate());
+  CPPUNIT_ASSERT(!bucket.exhausted());
+  bucket.setRate(0);
+  bucket.consume(1000000);
+  CPPUNIT_ASSERT(!bucket.exhausted());
+}
+
+} // namespace aria2
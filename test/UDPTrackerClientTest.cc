@@ -19,6 +19,8 @@ class UDPTrackerClientTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testConnectFollowedByAnnounce);
   CPPUNIT_TEST(testRequestFailure);
   CPPUNIT_TEST(testTimeout);
+  CPPUNIT_TEST(testTimeout_order);
+  CPPUNIT_TEST(testTransactionIdCollision);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -29,6 +31,8 @@ public:
   void testConnectFollowedByAnnounce();
   void testRequestFailure();
   void testTimeout();
+  void testTimeout_order();
+  void testTransactionIdCollision();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(UDPTrackerClientTest);
@@ -59,6 +63,31 @@ std::shared_ptr<UDPTrackerRequest> createAnnounce(const std::string& remoteAddr,
 }
 } // namespace
 
+namespace {
+std::shared_ptr<UDPTrackerRequest> createConnect(const std::string& remoteAddr,
+                                                 uint16_t remotePort,
+                                                 uint32_t transactionId)
+{
+  auto req = std::make_shared<UDPTrackerRequest>();
+  req->action = UDPT_ACT_CONNECT;
+  req->remoteAddr = remoteAddr;
+  req->remotePort = remotePort;
+  req->transactionId = transactionId;
+  return req;
+}
+} // namespace
+
+namespace {
+void sendRequest(UDPTrackerClient& tr, const Timer& now)
+{
+  unsigned char data[100];
+  std::string remoteAddr;
+  uint16_t remotePort;
+  tr.createRequest(data, sizeof(data), remoteAddr, remotePort, now);
+  tr.requestSent(now);
+}
+} // namespace
+
 namespace {
 ssize_t createErrorReply(unsigned char* data, size_t len,
                          uint32_t transactionId, const std::string& errorString)
@@ -468,4 +497,86 @@ void UDPTrackerClientTest::testTimeout()
   }
 }
 
+void UDPTrackerClientTest::testTimeout_order()
+{
+  unsigned char data[100];
+  Timer now;
+  UDPTrackerClient tr;
+  std::shared_ptr<UDPTrackerRequest> recvReq;
+  // Transaction IDs in the reverse order of sending
+  auto req1 = createConnect("192.168.0.1", 6991, 3);
+  auto req2 = createConnect("192.168.0.2", 6991, 2);
+  auto req3 = createConnect("192.168.0.3", 6991, 1);
+  auto req4 = createConnect("192.168.0.4", 6991, 4);
+
+  tr.addRequest(req1);
+  sendRequest(tr, now);
+  now.advance(1_s);
+  tr.addRequest(req2);
+  sendRequest(tr, now);
+  now.advance(1_s);
+  tr.addRequest(req3);
+  tr.addRequest(req4);
+  sendRequest(tr, now);
+  sendRequest(tr, now);
+  CPPUNIT_ASSERT_EQUAL((size_t)4, tr.getInflightRequests().size());
+
+  // req4 is answered and must not time out.
+  auto rv = createConnectReply(data, sizeof(data), 12345, 4);
+  CPPUNIT_ASSERT_EQUAL(0, tr.receiveReply(recvReq, data, rv, "192.168.0.4",
+                                          6991, now));
+  CPPUNIT_ASSERT(req4 == recvReq);
+
+  // req1 and req2 have expired, but req3 has not.
+  now.advance(4_s);
+  tr.handleTimeout(now);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, tr.getPendingRequests().size());
+  CPPUNIT_ASSERT(req1 == tr.getPendingRequests()[0]);
+  CPPUNIT_ASSERT(req2 == tr.getPendingRequests()[1]);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, tr.getInflightRequests().size());
+  CPPUNIT_ASSERT_EQUAL(1, req1->failCount);
+  CPPUNIT_ASSERT_EQUAL(0, req3->failCount);
+
+  now.advance(1_s);
+  tr.handleTimeout(now);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, tr.getPendingRequests().size());
+  CPPUNIT_ASSERT(req3 == tr.getPendingRequests()[0]);
+  CPPUNIT_ASSERT(tr.getInflightRequests().empty());
+  CPPUNIT_ASSERT_EQUAL(0, req4->failCount);
+}
+
+void UDPTrackerClientTest::testTransactionIdCollision()
+{
+  unsigned char data[100];
+  Timer now;
+  UDPTrackerClient tr;
+  std::shared_ptr<UDPTrackerRequest> recvReq;
+  auto req1 = createConnect("192.168.0.1", 6991, 100);
+  auto req2 = createConnect("192.168.0.2", 6991, 100);
+
+  tr.addRequest(req1);
+  tr.addRequest(req2);
+  sendRequest(tr, now);
+  sendRequest(tr, now);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, tr.getInflightRequests().count(100));
+
+  // The reply is matched by the address of the tracker as well.
+  auto rv = createConnectReply(data, sizeof(data), 12345, 100);
+  CPPUNIT_ASSERT_EQUAL(-1, tr.receiveReply(recvReq, data, rv, "192.168.0.3",
+                                           6991, now));
+  CPPUNIT_ASSERT_EQUAL(0, tr.receiveReply(recvReq, data, rv, "192.168.0.2",
+                                          6991, now));
+  CPPUNIT_ASSERT(req2 == recvReq);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, tr.getInflightRequests().size());
+  CPPUNIT_ASSERT(req1 == (*tr.getInflightRequests().find(100)).second);
+
+  // Only req1 times out.
+  now.advance(5_s);
+  tr.handleTimeout(now);
+  CPPUNIT_ASSERT(tr.getInflightRequests().empty());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, tr.getPendingRequests().size());
+  CPPUNIT_ASSERT(req1 == tr.getPendingRequests()[0]);
+  CPPUNIT_ASSERT_EQUAL(0, req2->failCount);
+}
+
 } // namespace aria2